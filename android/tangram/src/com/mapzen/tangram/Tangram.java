@@ -93,7 +93,7 @@ public class Tangram extends GLSurfaceView implements Renderer, OnTouchListener,
         setOnTouchListener(this);
         setEGLContextClientVersion(2);
         setPreserveEGLContextOnPause(true);
-        setEGLConfigChooser(8, 8, 8, 8, 24, 0);
+        setEGLConfigChooser(8, 8, 8, 8, 24, 8);
         setRenderer(this);
         setRenderMode(GLSurfaceView.RENDERMODE_WHEN_DIRTY);
 
@@ -13,7 +13,9 @@ attribute vec4 a_position;
 attribute vec4 a_color;
 attribute vec3 a_normal;
 attribute vec2 a_texcoord;
-attribute float a_layer;
+#ifndef TANGRAM_QUANTIZED_VERTICES
+    attribute float a_layer;
+#endif
 
 varying vec4 v_color;
 varying vec3 v_eyeToPoint;
@@ -31,7 +33,13 @@ varying vec2 v_texcoord;
 void main() {
 
     // Position
-    vec4 position = a_position;
+    #ifdef TANGRAM_QUANTIZED_VERTICES
+        vec4 position = vec4(a_position.xyz / TANGRAM_QUANTIZED_POSITION_SCALE, 1.);
+        float layer = a_position.w / TANGRAM_QUANTIZED_LAYER_SCALE;
+    #else
+        vec4 position = a_position;
+        float layer = a_layer;
+    #endif
 
     // Modify position before camera projection
     #pragma tangram: position
@@ -65,6 +73,6 @@ void main() {
     gl_Position.z /= 1. + .1 * (abs(u_tile_zoom) - u_tile_zoom);
     
     #ifdef TANGRAM_DEPTH_DELTA
-        gl_Position.z -= a_layer * TANGRAM_DEPTH_DELTA * gl_Position.w;
+        gl_Position.z -= layer * TANGRAM_DEPTH_DELTA * gl_Position.w;
     #endif
 }
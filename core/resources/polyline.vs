@@ -16,7 +16,9 @@ attribute vec4 a_color;
 attribute vec3 a_extrudeNormal;
 attribute float a_extrudeWidth;
 attribute vec2 a_texcoord;
-attribute float a_layer;
+#ifndef TANGRAM_QUANTIZED_VERTICES
+    attribute float a_layer;
+#endif
 
 varying vec4 v_world_position;
 varying vec4 v_color;
@@ -34,14 +36,24 @@ varying vec2 v_texcoord;
 
 void main() {
 
-    vec4 position = a_position;
-    position.xyz += a_extrudeNormal * (a_extrudeWidth * 2.) * pow(2., abs(u_tile_zoom) - u_zoom);
+    #ifdef TANGRAM_QUANTIZED_VERTICES
+        vec4 basePosition = vec4(a_position.xyz / TANGRAM_QUANTIZED_POSITION_SCALE, 1.);
+        vec3 extrudeNormal = vec3(a_extrudeNormal.xy / TANGRAM_QUANTIZED_EXTRUDE_SCALE, 0.);
+        float layer = a_position.w / TANGRAM_QUANTIZED_LAYER_SCALE;
+    #else
+        vec4 basePosition = a_position;
+        vec3 extrudeNormal = a_extrudeNormal;
+        float layer = a_layer;
+    #endif
+
+    vec4 position = basePosition;
+    position.xyz += extrudeNormal * (a_extrudeWidth * 2.) * pow(2., abs(u_tile_zoom) - u_zoom);
 
     // Modify position before camera projection
     #pragma tangram: position
 
     v_color = a_color;
-    v_eyeToPoint = vec3(u_modelView * a_position);
+    v_eyeToPoint = vec3(u_modelView * basePosition);
     v_normal = u_normalMatrix * vec3(0.,0.,1.);
     v_texcoord = a_texcoord;
         
@@ -68,6 +80,6 @@ void main() {
     gl_Position.z /= 1. + .1 * (abs(u_tile_zoom) - u_tile_zoom);
     
     #ifdef TANGRAM_DEPTH_DELTA
-        gl_Position.z -= a_layer * TANGRAM_DEPTH_DELTA * gl_Position.w;
+        gl_Position.z -= layer * TANGRAM_DEPTH_DELTA * gl_Position.w;
     #endif
 }
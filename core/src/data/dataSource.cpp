@@ -5,6 +5,7 @@
 #include "tileData.h"
 #include "mapTile.h"
 #include "tileManager.h"
+#include "clipping.h"
 #include "labels/labels.h"
 
 //---- DataSource Implementation----
@@ -38,6 +39,23 @@ void DataSource::clearData() {
     m_tileStore.clear();
 }
 
+void DataSource::setGeometryProcessing(float _clipBuffer, float _simplifyPixels) {
+    
+    m_clipBuffer = _clipBuffer;
+    
+    // A tile spans 2 units over 256 pixels at its own zoom and is displayed up to twice as large
+    // before being replaced by the next zoom level, so a pixel is never smaller than 1/256 units.
+    // The tolerance is constant in tile units, which halves it in world units with every zoom level
+    m_simplifyTolerance = _simplifyPixels / 256.f;
+    
+}
+
+void DataSource::processTileData(TileData& _tileData) const {
+    
+    Clipping::processTileData(_tileData, m_clipBuffer, m_simplifyTolerance);
+    
+}
+
 void DataSource::setTileData(const TileID& _tileID, const std::shared_ptr<TileData>& _tileData) {
     
         std::lock_guard<std::mutex> lock(m_mutex);
@@ -50,6 +50,15 @@ public:
     /* Clears all data associated with this DataSource */
     void clearData();
 
+    /* Sets the client-side processing of parsed tile data: geometry is clipped to the tile extended by
+     * @_clipBuffer on each side (in tile units, negative to disable clipping) and simplified with a 
+     * tolerance of @_simplifyPixels screen pixels (0 to disable simplification)
+     */
+    void setGeometryProcessing(float _clipBuffer, float _simplifyPixels);
+
+    /* Applies the geometry processing of this source to freshly parsed @_tileData */
+    void processTileData(TileData& _tileData) const;
+
 protected:
 
     /* Constructs the URL of a tile using <m_urlTemplate> */
@@ -63,4 +72,8 @@ protected:
 
     std::string m_urlTemplate; // URL template for requesting tiles from a network or filesystem
 
+    float m_clipBuffer = -1.f; // Buffer around the tile to clip geometry to, in tile units; negative when not clipping
+
+    float m_simplifyTolerance = 0.f; // Simplification tolerance in tile units; 0 when not simplifying
+
 };
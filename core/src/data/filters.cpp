@@ -0,0 +1,187 @@
+#include "filters.h"
+
+namespace Tangram {
+
+    CompiledFilter::CompiledFilter(const Filter& _filter) {
+
+        compile(_filter);
+
+    }
+
+    uint16_t CompiledFilter::internKey(const std::string& _key) {
+
+        for (size_t i = 0; i < m_keys.size(); i++) {
+            if (m_keys[i] == _key) { return i; }
+        }
+        m_keys.push_back(_key);
+        return m_keys.size() - 1;
+
+    }
+
+    void CompiledFilter::compile(const Filter& _filter) {
+
+        uint32_t index = m_ops.size();
+        m_ops.push_back(Op());
+        Op op = { OpType::FALSE, false, 0, 0, 0, 0, 0.f, 0.f };
+
+        // Node types are only inspected here, once, at scene load
+        if (auto opFilter = dynamic_cast<const Operator*>(&_filter)) {
+
+            if (dynamic_cast<const Any*>(opFilter)) { op.type = OpType::ANY; }
+            else if (dynamic_cast<const All*>(opFilter)) { op.type = OpType::ALL; }
+            else if (dynamic_cast<const None*>(opFilter)) { op.type = OpType::NONE; }
+
+            if (op.type != OpType::FALSE) {
+                for (const Filter* operand : opFilter->operands) {
+                    compile(*operand);
+                }
+            }
+
+        } else if (auto existence = dynamic_cast<const Existence*>(&_filter)) {
+
+            op.type = OpType::EXISTENCE;
+            op.key = internKey(existence->key);
+            op.exists = existence->exists;
+
+        } else if (auto equality = dynamic_cast<const Equality*>(&_filter)) {
+
+            op.type = OpType::EQUALITY;
+            op.key = internKey(equality->key);
+            op.valuesBegin = m_values.size();
+            for (const Value* value : equality->values) {
+                m_values.push_back({ value->num, value->str, value->isNum });
+            }
+            op.valuesEnd = m_values.size();
+
+        } else if (auto range = dynamic_cast<const Range*>(&_filter)) {
+
+            op.type = OpType::RANGE;
+            op.key = internKey(range->key);
+            op.min = range->min;
+            op.max = range->max;
+
+        }
+
+        op.next = m_ops.size();
+        m_ops[index] = op;
+
+    }
+
+    const CompiledFilter::Slot& CompiledFilter::resolve(uint16_t _key, const Feature& _feat, const Context& _ctx, Slot* _slots) const {
+
+        Slot& slot = _slots[_key];
+
+        if (!slot.resolved) {
+            const std::string& key = m_keys[_key];
+            slot.resolved = true;
+            slot.ctx = nullptr;
+            slot.str = nullptr;
+            slot.num = nullptr;
+
+            auto ctxIt = _ctx.find(key);
+            if (ctxIt != _ctx.end()) {
+                slot.ctx = ctxIt->second;
+            } else {
+                auto strIt = _feat.props.stringProps.find(key);
+                if (strIt != _feat.props.stringProps.end()) { slot.str = &strIt->second; }
+                auto numIt = _feat.props.numericProps.find(key);
+                if (numIt != _feat.props.numericProps.end()) { slot.num = &numIt->second; }
+            }
+        }
+
+        return slot;
+
+    }
+
+    bool CompiledFilter::evalOp(uint32_t _index, const Feature& _feat, const Context& _ctx, Slot* _slots) const {
+
+        const Op& op = m_ops[_index];
+
+        switch (op.type) {
+            case OpType::ANY:
+                for (uint32_t i = _index + 1; i < op.next; i = m_ops[i].next) {
+                    if (evalOp(i, _feat, _ctx, _slots)) { return true; }
+                }
+                return false;
+            case OpType::ALL:
+                for (uint32_t i = _index + 1; i < op.next; i = m_ops[i].next) {
+                    if (!evalOp(i, _feat, _ctx, _slots)) { return false; }
+                }
+                return true;
+            case OpType::NONE:
+                for (uint32_t i = _index + 1; i < op.next; i = m_ops[i].next) {
+                    if (evalOp(i, _feat, _ctx, _slots)) { return false; }
+                }
+                return true;
+            case OpType::EXISTENCE:
+            {
+                const Slot& slot = resolve(op.key, _feat, _ctx, _slots);
+                bool found = slot.ctx || slot.str || slot.num;
+                return op.exists == found;
+            }
+            case OpType::EQUALITY:
+            {
+                // Same semantics as <Equality> and the equals() methods of <NumValue> and <StrValue>
+                const Slot& slot = resolve(op.key, _feat, _ctx, _slots);
+                for (uint32_t i = op.valuesBegin; i < op.valuesEnd; i++) {
+                    const ValueData& value = m_values[i];
+                    if (slot.ctx) {
+                        const Value& ctxValue = *slot.ctx;
+                        if (value.isNum ? (ctxValue.isNum && ctxValue.num == value.num)
+                                        : (ctxValue.isNum ? (ctxValue.str.size() != 0 && ctxValue.str == value.str)
+                                                          : ctxValue.str == value.str)) {
+                            return true;
+                        }
+                        continue;
+                    }
+                    if (slot.str && (value.isNum ? (value.str.size() != 0 && value.str == *slot.str) : value.str == *slot.str)) {
+                        return true;
+                    }
+                    if (slot.num && value.isNum && value.num == *slot.num) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            case OpType::RANGE:
+            {
+                const Slot& slot = resolve(op.key, _feat, _ctx, _slots);
+                if (slot.ctx) {
+                    if (!slot.ctx->isNum) { return false; } // only check range for numbers
+                    return slot.ctx->num >= op.min && slot.ctx->num < op.max;
+                }
+                if (slot.num) {
+                    return *slot.num >= op.min && *slot.num < op.max;
+                }
+                return false;
+            }
+            case OpType::FALSE:
+            default:
+                return false;
+        }
+
+    }
+
+    bool CompiledFilter::eval(const Feature& _feat, const Context& _ctx) const {
+
+        if (m_ops.empty()) { return true; }
+
+        // Slots live on the stack for all but unusually large filters
+        const size_t maxLocalSlots = 16;
+        Slot localSlots[maxLocalSlots];
+        std::vector<Slot> heapSlots;
+        Slot* slots = localSlots;
+
+        if (m_keys.size() > maxLocalSlots) {
+            heapSlots.resize(m_keys.size());
+            slots = heapSlots.data();
+        }
+        for (size_t i = 0; i < m_keys.size(); i++) {
+            slots[i].resolved = false;
+        }
+
+        return evalOp(0, _feat, _ctx, slots);
+
+    }
+
+}
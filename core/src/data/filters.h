@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tileData.h"
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 #include <limits>
@@ -11,6 +12,7 @@ namespace Tangram {
 
         float num;
         std::string str;
+        bool isNum; // type tag, so that compiled filters can compare values without virtual calls
 
         virtual bool equals(float f) const = 0;
         virtual bool equals(const std::string& s) const = 0;
@@ -18,9 +20,9 @@ namespace Tangram {
 
         virtual ~Value() {};
 
-        Value(float n) : num(n) {}
-        Value(float n, const std::string& s) : num(n), str(s) {}
-        Value(const std::string& s) : str(s) {}
+        Value(float n) : num(n), isNum(true) {}
+        Value(float n, const std::string& s) : num(n), str(s), isNum(true) {}
+        Value(const std::string& s) : num(0), str(s), isNum(false) {}
 
     };
 
@@ -186,4 +188,66 @@ namespace Tangram {
         }
 
     };
+
+    /* Flat, non-virtual form of a <Filter> tree, compiled once at scene load and evaluated per feature.
+     *
+     * Nodes of the tree are stored in prefix order in a single array; each operation records the index 
+     * following its subtree so that short-circuited operands are skipped without being visited. Keys are
+     * interned into slots, which are looked up at most once in each evaluation, and values are compared
+     * through their type tag rather than virtual calls. An empty CompiledFilter accepts every feature.
+     */
+    class CompiledFilter {
+
+    public:
+
+        CompiledFilter() {}
+
+        /* Compiles the given filter tree; the tree is not referenced afterwards */
+        explicit CompiledFilter(const Filter& _filter);
+
+        bool empty() const { return m_ops.empty(); }
+
+        bool eval(const Feature& _feat, const Context& _ctx) const;
+
+    private:
+
+        enum class OpType : char { FALSE, ANY, ALL, NONE, EXISTENCE, EQUALITY, RANGE };
+
+        struct Op {
+            OpType type;
+            bool exists;
+            uint16_t key; // slot of the key of a predicate
+            uint32_t next; // index of the first operation after this one's subtree
+            uint32_t valuesBegin; // range of m_values for an equality
+            uint32_t valuesEnd;
+            float min; // bounds of a range
+            float max;
+        };
+
+        /* Property of a feature (or context value) for a key, resolved on first use in an evaluation */
+        struct Slot {
+            bool resolved;
+            const Value* ctx;
+            const std::string* str;
+            const float* num;
+        };
+
+        void compile(const Filter& _filter);
+        uint16_t internKey(const std::string& _key);
+        bool evalOp(uint32_t _index, const Feature& _feat, const Context& _ctx, Slot* _slots) const;
+        const Slot& resolve(uint16_t _key, const Feature& _feat, const Context& _ctx, Slot* _slots) const;
+
+        /* Copy of an equality value, without the vtable of <Value> */
+        struct ValueData {
+            float num;
+            std::string str;
+            bool isNum;
+        };
+
+        std::vector<Op> m_ops;
+        std::vector<std::string> m_keys;
+        std::vector<ValueData> m_values;
+
+    };
+
 }
@@ -5,9 +5,7 @@
 
 #include "geoJsonSource.h"
 #include "rapidjson/error/en.h"
-#include "rapidjson/memorystream.h"
-#include "rapidjson/encodings.h"
-#include "rapidjson/encodedstream.h"
+#include "rapidjson/reader.h"
 
 
 GeoJsonSource::GeoJsonSource(const std::string& _name, const std::string& _urlTemplate) :
@@ -18,31 +16,27 @@ std::shared_ptr<TileData> GeoJsonSource::parse(const MapTile& _tile, std::vector
 
     std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
 
-    // parse written data into a JSON object
-    rapidjson::Document doc;
+    // parse the JSON text in-situ, strings are decoded inside the raw data buffer itself
+    _rawData.push_back('\0');
+    rapidjson::InsituStringStream stream(_rawData.data());
 
-    rapidjson::MemoryStream ms(_rawData.data(), _rawData.size());
-    rapidjson::EncodedInputStream<rapidjson::UTF8<char>, rapidjson::MemoryStream> is(ms);
+    // transform JSON data into a TileData as it is read, using a GeoJson handler
+    GeoJson::TileHandler handler(*tileData, _tile);
+    rapidjson::Reader reader;
 
-    doc.ParseStream(is);
+    reader.Parse<rapidjson::kParseInsituFlag>(stream, handler);
 
-    if (doc.HasParseError()) {
+    if (reader.HasParseError()) {
 
-        size_t offset = doc.GetErrorOffset();
-        const char* error = rapidjson::GetParseError_En(doc.GetParseError());
+        size_t offset = reader.GetErrorOffset();
+        const char* error = rapidjson::GetParseError_En(reader.GetParseErrorCode());
         logMsg("Json parsing failed on tile [%d, %d, %d]: %s (%u)\n", _tile.getID().z, _tile.getID().x, _tile.getID().y, error, offset);
+        tileData->layers.clear();
         return tileData;
 
     }
 
-    // transform JSON data into a TileData using GeoJson functions
-    for (auto layer = doc.MemberBegin(); layer != doc.MemberEnd(); ++layer) {
-        tileData->layers.emplace_back(std::string(layer->name.GetString()));
-        GeoJson::extractLayer(layer->value, tileData->layers.back(), _tile);
-    }
-
-
-    // Discard original JSON object and return TileData
+    // Return TileData, no intermediate JSON object was created
 
     return tileData;
 
@@ -67,6 +67,13 @@ struct Properties {
     
     std::unordered_map<std::string, std::string> stringProps;
     std::unordered_map<std::string, float> numericProps;
+
+    /* Returns the numeric property _key, or _default if it is not set; unlike numericProps[] this never
+     * inserts the key, since features of cached tile data are shared between builds */
+    float getNumeric(const std::string& _key, float _default = 0.f) const {
+        auto it = numericProps.find(_key);
+        return it != numericProps.end() ? it->second : _default;
+    }
     
 };
 
@@ -0,0 +1,60 @@
+#include "topoJson.h"
+#include "platform.h"
+#include "tileID.h"
+
+#include "topoJsonSource.h"
+#include "rapidjson/error/en.h"
+
+
+TopoJsonSource::TopoJsonSource(const std::string& _name, const std::string& _urlTemplate) :
+    DataSource(_name, _urlTemplate) {
+}
+
+std::shared_ptr<TileData> TopoJsonSource::parse(const MapTile& _tile, std::vector<char>& _rawData) const {
+
+    std::shared_ptr<TileData> tileData = std::make_shared<TileData>();
+
+    // parse written data into a JSON object, in-situ in the raw data buffer
+    rapidjson::Document doc;
+
+    _rawData.push_back('\0');
+    doc.ParseInsitu(_rawData.data());
+
+    if (doc.HasParseError()) {
+
+        size_t offset = doc.GetErrorOffset();
+        const char* error = rapidjson::GetParseError_En(doc.GetParseError());
+        logMsg("Json parsing failed on tile [%d, %d, %d]: %s (%u)\n", _tile.getID().z, _tile.getID().x, _tile.getID().y, error, offset);
+        return tileData;
+
+    }
+
+    if (!doc.IsObject()) {
+        logMsg("ERROR: TopoJSON of tile [%d, %d, %d] is not an object\n", _tile.getID().z, _tile.getID().x, _tile.getID().y);
+        return tileData;
+    }
+
+    const auto& objectsIter = doc.FindMember("objects");
+
+    if (objectsIter == doc.MemberEnd() || !objectsIter->value.IsObject()) {
+        logMsg("ERROR: TopoJSON missing 'objects' object\n");
+        return tileData;
+    }
+
+    // decode the arcs shared by all layers once
+    TopoJson::Topology topology;
+    TopoJson::extractTopology(doc, topology, _tile);
+
+    // transform JSON data into a TileData using TopoJson functions
+    const auto& objects = objectsIter->value;
+    for (auto layer = objects.MemberBegin(); layer != objects.MemberEnd(); ++layer) {
+        tileData->layers.emplace_back(std::string(layer->name.GetString()));
+        TopoJson::extractLayer(layer->value, tileData->layers.back(), topology, _tile);
+    }
+
+
+    // Discard original JSON object and return TileData
+
+    return tileData;
+
+}
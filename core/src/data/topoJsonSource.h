@@ -0,0 +1,19 @@
+#pragma once
+
+#include "dataSource.h"
+#include "mapTile.h"
+#include "tileData.h"
+
+
+/* Extends DataSource class to read Mapzen's TopoJSON vector tiles */
+class TopoJsonSource: public DataSource {
+    
+protected:
+    
+    virtual std::shared_ptr<TileData> parse(const MapTile& _tile, std::vector<char>& _rawData) const override;
+    
+public:
+    
+    TopoJsonSource(const std::string& _name, const std::string& _urlTemplate);
+    
+};
@@ -10,9 +10,19 @@ Scene::Scene() {
 }
 
 void Scene::addStyle(std::unique_ptr<Style> _style) {
+    _style->setID(m_styles.size());
     m_styles.push_back(std::move(_style));
 }
 
+void Scene::addLayerRule(const std::string& _layer, int _style, int _rule) {
+    m_layerRules[_layer].push_back({ _style, _rule });
+}
+
+const std::vector<StyleRule>* Scene::getLayerRules(const std::string& _layer) const {
+    auto it = m_layerRules.find(_layer);
+    return it != m_layerRules.end() ? &it->second : nullptr;
+}
+
 void Scene::addLight(std::unique_ptr<Light> _light) {
 
     // Avoid duplications
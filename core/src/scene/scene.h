@@ -12,19 +12,33 @@
  * Scene is a singleton containing the styles, lighting, and interactions defining a map scene
  */
 
+/* A rule of a style for a data layer: the index of the style in the scene and the index of the layer rule in the style */
+struct StyleRule {
+    int style;
+    int rule;
+};
+
 class Scene {
 public:
 
     Scene();
 
+    /* Adds _style to the scene and assigns it the next style ID, its index in <getStyles()> */
     void addStyle(std::unique_ptr<Style> _style);
     void addLight(std::unique_ptr<Light> _light);
 
     std::vector<std::unique_ptr<Style>>& getStyles() { return m_styles; };
+    const std::vector<std::unique_ptr<Style>>& getStyles() const { return m_styles; };
     std::vector<std::unique_ptr<Light>>& getLights() { return m_lights; };
 
     std::unordered_map<std::string, std::shared_ptr<Texture>>& getTextures() { return m_textures; };
 
+    /* Adds a rule of the style at index _style in the scene to the dispatch table entry of data layer _layer */
+    void addLayerRule(const std::string& _layer, int _style, int _rule);
+
+    /* Returns the style rules to route features of data layer _layer to, or nullptr if no style draws it */
+    const std::vector<StyleRule>* getLayerRules(const std::string& _layer) const;
+
 private:
 
     std::vector<std::unique_ptr<Style>> m_styles;
@@ -32,5 +46,8 @@ private:
 
     std::unordered_map<std::string, std::shared_ptr<Texture>> m_textures;
 
+    /* Dispatch table built at scene load, from data layer names to the style rules that apply to them */
+    std::unordered_map<std::string, std::vector<StyleRule>> m_layerRules;
+
 };
 
@@ -7,6 +7,7 @@
 #include "view.h"
 #include "lights.h"
 #include "geoJsonSource.h"
+#include "topoJsonSource.h"
 #include "mvtSource.h"
 #include "polygonStyle.h"
 #include "polylineStyle.h"
@@ -275,11 +276,11 @@ void SceneLoader::loadTextures(YAML::Node textures, Scene& scene) {
 void SceneLoader::loadStyles(YAML::Node styles, Scene& scene) {
 
     // Instantiate built-in styles
-    scene.getStyles().emplace_back(new PolygonStyle("polygons"));
-    scene.getStyles().emplace_back(new PolylineStyle("lines"));
-    scene.getStyles().emplace_back(new TextStyle("FiraSans", "text", 15.0f, 0xF7F0E1, true, true));
-    scene.getStyles().emplace_back(new DebugTextStyle("FiraSans", "debugtext", 30.0f, 0xDC3522, true));
-    scene.getStyles().emplace_back(new DebugStyle("debug"));
+    scene.addStyle(std::unique_ptr<Style>(new PolygonStyle("polygons")));
+    scene.addStyle(std::unique_ptr<Style>(new PolylineStyle("lines")));
+    scene.addStyle(std::unique_ptr<Style>(new TextStyle("FiraSans", "text", 15.0f, 0xF7F0E1, true, true)));
+    scene.addStyle(std::unique_ptr<Style>(new DebugTextStyle("FiraSans", "debugtext", 30.0f, 0xDC3522, true)));
+    scene.addStyle(std::unique_ptr<Style>(new DebugStyle("debug")));
 
     if (!styles) {
         return;
@@ -356,6 +357,21 @@ void SceneLoader::loadStyles(YAML::Node styles, Scene& scene) {
             else { logMsg("WARNING: unrecognized lighting type \"%s\"\n", lighting.c_str()); }
         }
 
+        Node retainNode = styleNode["retain_vertices"];
+        if (retainNode) {
+            style->setRetainVertexData(retainNode.as<bool>());
+        }
+
+        Node quantizeNode = styleNode["quantize_vertices"];
+        if (quantizeNode) {
+            style->setQuantizeVertices(quantizeNode.as<bool>());
+        }
+
+        Node optimizeNode = styleNode["optimize_vertex_cache"];
+        if (optimizeNode) {
+            style->setOptimizeVertexCache(optimizeNode.as<bool>());
+        }
+
         Node urlNode = styleNode["url"];
         if (urlNode) { logMsg("WARNING: loading style from URL not yet implemented\n"); } // TODO
 
@@ -384,7 +400,7 @@ void SceneLoader::loadSources(Node sources, TileManager& tileManager) {
         if (type == "GeoJSONTiles") {
             sourcePtr = std::unique_ptr<DataSource>(new GeoJsonSource(name, url));
         } else if (type == "TopoJSONTiles") {
-            logMsg("WARNING: TopoJSON data sources not yet implemented\n"); // TODO
+            sourcePtr = std::unique_ptr<DataSource>(new TopoJsonSource(name, url));
         } else if (type == "MVT") {
             sourcePtr = std::unique_ptr<DataSource>(new MVTSource(name, url));
         } else {
@@ -392,6 +408,12 @@ void SceneLoader::loadSources(Node sources, TileManager& tileManager) {
         }
 
         if (sourcePtr) {
+            // Optional client-side clipping (buffer in tile units) and simplification (tolerance in pixels)
+            Node clipNode = source["clip_buffer"];
+            Node simplifyNode = source["simplify"];
+            if (clipNode || simplifyNode) {
+                sourcePtr->setGeometryProcessing(clipNode ? clipNode.as<float>() : -1.f, simplifyNode ? simplifyNode.as<float>() : 0.f);
+            }
             tileManager.addDataSource(std::move(sourcePtr));
         }
     }
@@ -765,16 +787,26 @@ void SceneLoader::loadLayers(Node layers, Scene& scene, TileManager& tileManager
         Node dataLayer = data["layer"];
         if (dataLayer) { name = dataLayer.as<std::string>(); }
 
+        // Compile the layer's filter once, to be evaluated against each feature of the layer
+        CompiledFilter filter;
+        Node filterNode = layerIt->second["filter"];
+        if (filterNode) {
+            std::unique_ptr<Filter> filterTree(generateFilter(filterNode));
+            filter = CompiledFilter(*filterTree);
+        }
+
         for (auto groupIt = drawGroup.begin(); groupIt != drawGroup.end(); ++groupIt) {
 
             StyleParamMap paramMap;
             std::string styleName = groupIt->first.as<std::string>();
             parseStyleProps(groupIt->second, paramMap);
 
-            // match layer to the style in scene with the given name
-            for (const auto& style : scene.getStyles()) {
-                if (style->getName() == styleName) {
-                    style->addLayer({ name, paramMap });
+            // match layer to the style in scene with the given name, and enter it in the scene's dispatch table
+            const auto& styles = scene.getStyles();
+            for (size_t i = 0; i < styles.size(); i++) {
+                if (styles[i]->getName() == styleName) {
+                    int rule = styles[i]->addLayer({ name, paramMap, filter });
+                    scene.addLayerRule(name, i, rule);
                 }
             }
 
@@ -27,11 +27,11 @@ void DebugStyle::constructShaderProgram() {
 
 }
 
-void* DebugStyle::parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) {
+void* DebugStyle::parseStyleParams(const StyleParamMap& _styleParamMap) {
     return nullptr;
 }
 
-void DebugStyle::addData(TileData &_data, MapTile &_tile, const MapProjection &_mapProjection) {
+void DebugStyle::addData(const std::vector<StyledFeature> &_features, MapTile &_tile, const MapProjection &_mapProjection) {
 
     if (Tangram::getDebugFlag(Tangram::DebugFlags::TILE_BOUNDS)) {
 
@@ -58,19 +58,19 @@ void DebugStyle::addData(TileData &_data, MapTile &_tile, const MapProjection &_
 
 }
 
-void DebugStyle::buildPoint(Point &_point, void* _styleParams, Properties &_props, VboMesh &_mesh) const {
+void DebugStyle::buildPoint(Point &_point, void* _styleParams, Properties &_props, VboMesh &_mesh, const MapTile &_tile) const {
 
     // No-op
 
 }
 
-void DebugStyle::buildLine(Line &_line, void* _styleParams, Properties &_props, VboMesh &_mesh) const {
+void DebugStyle::buildLine(Line &_line, void* _styleParams, Properties &_props, VboMesh &_mesh, const MapTile &_tile) const {
 
     // No-op
 
 }
 
-void DebugStyle::buildPolygon(Polygon &_polygon, void* _styleParams, Properties &_props, VboMesh &_mesh) const {
+void DebugStyle::buildPolygon(Polygon &_polygon, void* _styleParams, Properties &_props, VboMesh &_mesh, const MapTile &_tile) const {
 
     // No-op
 
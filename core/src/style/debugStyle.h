@@ -16,12 +16,12 @@ protected:
 
     virtual void constructVertexLayout() override;
     virtual void constructShaderProgram() override;
-    virtual void buildPoint(Point& _point, void* _styleParams, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildLine(Line& _line, void* _styleParams, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildPolygon(Polygon& _polygon, void* _styleParams, Properties& _props, VboMesh& _mesh) const override;
-    virtual void addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) override;
+    virtual void buildPoint(Point& _point, void* _styleParams, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const override;
+    virtual void buildLine(Line& _line, void* _styleParams, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const override;
+    virtual void buildPolygon(Polygon& _polygon, void* _styleParams, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const override;
+    virtual void addData(const std::vector<StyledFeature>& _features, MapTile& _tile, const MapProjection& _mapProjection) override;
 
-    virtual void* parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) override;
+    virtual void* parseStyleParams(const StyleParamMap& _styleParamMap) override;
 
     typedef TypedMesh<PosColVertex> Mesh;
 
@@ -6,7 +6,7 @@ DebugTextStyle::DebugTextStyle(const std::string& _fontName, std::string _name,
 : TextStyle(_fontName, _name, _fontSize, _color, _sdf, false, _drawMode) {
 }
 
-void DebugTextStyle::addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) {
+void DebugTextStyle::addData(const std::vector<StyledFeature>& _features, MapTile& _tile, const MapProjection& _mapProjection) {
 
     if (Tangram::getDebugFlag(Tangram::DebugFlags::TILE_INFOS)) {
         onBeginBuildTile(_tile);
@@ -24,7 +24,7 @@ void DebugTextStyle::addData(TileData& _data, MapTile& _tile, const MapProjectio
         }
 
         std::string tileID = std::to_string(_tile.getID().x) + "/" + std::to_string(_tile.getID().y) + "/" + std::to_string(_tile.getID().z);
-        m_labels->addLabel(_tile, m_name, { glm::vec2(0), glm::vec2(0) }, tileID, Label::Type::DEBUG);
+        m_labels->addLabel(_tile, m_id, { glm::vec2(0), glm::vec2(0) }, tileID, Label::Type::DEBUG);
 
         onEndBuildTile(_tile, mesh);
 
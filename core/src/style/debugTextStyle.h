@@ -8,7 +8,7 @@ class DebugTextStyle : public TextStyle {
 
 protected:
 
-    virtual void addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) override;
+    virtual void addData(const std::vector<StyledFeature>& _features, MapTile& _tile, const MapProjection& _mapProjection) override;
 
 public:
 
@@ -9,6 +9,16 @@ PolygonStyle::PolygonStyle(std::string _name, GLenum _drawMode) : Style(_name, _
 void PolygonStyle::constructVertexLayout() {
 
     // TODO: Ideally this would be in the same location as the struct that it basically describes
+    if (m_quantizeVertices) {
+        m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
+            {"a_position", 4, GL_SHORT, false, 0},
+            {"a_normal", 4, GL_BYTE, true, 0},
+            {"a_texcoord", 2, GL_UNSIGNED_SHORT, true, 0},
+            {"a_color", 4, GL_UNSIGNED_BYTE, true, 0}
+        }));
+        return;
+    }
+
     m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
         {"a_position", 3, GL_FLOAT, false, 0},
         {"a_normal", 3, GL_FLOAT, false, 0},
@@ -27,11 +37,7 @@ void PolygonStyle::constructShaderProgram() {
     m_shaderProgram->setSourceStrings(fragShaderSrcStr, vertShaderSrcStr);
 }
 
-void* PolygonStyle::parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) {
-
-    if(m_styleParamCache.find(_layerNameID) != m_styleParamCache.end()) {
-        return static_cast<void*>(m_styleParamCache.at(_layerNameID));
-    }
+void* PolygonStyle::parseStyleParams(const StyleParamMap& _styleParamMap) {
 
     StyleParams* params = new StyleParams();
     if(_styleParamMap.find("order") != _styleParamMap.end()) {
@@ -41,70 +47,87 @@ void* PolygonStyle::parseStyleParams(const std::string& _layerNameID, const Styl
         params->color = parseColorProp(_styleParamMap.at("color"));
     }
 
-    {
-        std::lock_guard<std::mutex> lock(m_cacheMutex);
-        m_styleParamCache.emplace(_layerNameID, params);
-    }
+    m_parsedParams.emplace_back(params);
 
     return static_cast<void*>(params);
 }
 
-void PolygonStyle::buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolygonStyle::buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
     // No-op
 }
 
-void PolygonStyle::buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
-    std::vector<PosNormColVertex> vertices;
+void PolygonStyle::buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
+    if (m_quantizeVertices) {
+        buildLineVertices<QuantizedVertex>(_line, _mesh);
+    } else {
+        buildLineVertices<PosNormColVertex>(_line, _mesh);
+    }
+}
+
+template<class V>
+void PolygonStyle::buildLineVertices(Line& _line, VboMesh& _mesh) const {
+    auto& mesh = static_cast<TypedMesh<V>&>(_mesh);
 
-    PolyLineBuilder builder = {
+    auto builder = makePolyLineBuilder(
         [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
             float halfWidth =  0.2f;
             GLuint abgr = 0xff969696; // Default road color
 
             glm::vec3 point(coord.x + normal.x * halfWidth, coord.y + normal.y * halfWidth, coord.z);
-            vertices.push_back({ point, glm::vec3(0.0f, 0.0f, 1.0f), uv, abgr, 0.0f });
-        }
-    };
+            mesh.pushVertex(V{ point, glm::vec3(0.0f, 0.0f, 1.0f), uv, abgr, 0.0f });
+        },
+        [&](size_t sizeHint){ mesh.reserveVertices(sizeHint); }
+    );
 
     Builders::buildPolyLine(_line, builder);
 
-    auto& mesh = static_cast<PolygonStyle::Mesh&>(_mesh);
-    mesh.addVertices(std::move(vertices), std::move(builder.indices));
+    mesh.addIndices(builder.indices);
 }
 
-void PolygonStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolygonStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
+    if (m_quantizeVertices) {
+        buildPolygonVertices<QuantizedVertex>(_polygon, _styleParam, _props, _mesh, _tile);
+    } else {
+        buildPolygonVertices<PosNormColVertex>(_polygon, _styleParam, _props, _mesh, _tile);
+    }
+}
+
+template<class V>
+void PolygonStyle::buildPolygonVertices(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
 
-    std::vector<PosNormColVertex> vertices;
+    auto& mesh = static_cast<TypedMesh<V>&>(_mesh);
 
     StyleParams* params = static_cast<StyleParams*>(_styleParam);
     GLuint abgr = params->color;
     GLfloat layer = params->order;
 
     if (Tangram::getDebugFlag(Tangram::DebugFlags::PROXY_COLORS)) {
-        abgr = abgr << (int(_props.numericProps["zoom"]) % 6);
+        abgr = abgr << (_tile.getID().z % 6);
     }
 
-    float height = _props.numericProps["height"]; // Inits to zero if not present in data
-    float minHeight = _props.numericProps["min_height"]; // Inits to zero if not present in data
+    float height = _props.getNumeric("height");
+    float minHeight = _props.getNumeric("min_height");
 
-    PolygonBuilder builder = {
+    auto builder = makePolygonBuilder(
         [&](const glm::vec3& coord, const glm::vec3& normal, const glm::vec2& uv){
-            vertices.push_back({ coord, normal, uv, abgr, layer });
+            mesh.pushVertex(V{ coord, normal, uv, abgr, layer });
         },
-        [&](size_t sizeHint){ vertices.reserve(sizeHint); }
-    };
+        [&](size_t sizeHint){ mesh.reserveVertices(sizeHint); }
+    );
 
     if (minHeight != height) {
-        for (auto& line : _polygon) {
+        // Raise a copy of the rings to the roof, the feature's own geometry is shared between builds
+        Polygon roof = _polygon;
+        for (auto& line : roof) {
             for (auto& point : line) {
                 point.z = height;
             }
         }
-        Builders::buildPolygonExtrusion(_polygon, minHeight, builder);
+        Builders::buildPolygonExtrusion(roof, minHeight, builder);
+        Builders::buildPolygon(roof, builder);
+    } else {
+        Builders::buildPolygon(_polygon, builder);
     }
 
-    Builders::buildPolygon(_polygon, builder);
-
-    auto& mesh = static_cast<PolygonStyle::Mesh&>(_mesh);
-    mesh.addVertices(std::move(vertices), std::move(builder.indices));
+    mesh.addIndices(builder.indices);
 }
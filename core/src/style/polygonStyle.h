@@ -3,7 +3,7 @@
 #include "style.h"
 #include "typedMesh.h"
 
-#include <mutex>
+#include <memory>
 
 class PolygonStyle : public Style {
 
@@ -27,31 +27,54 @@ protected:
         GLfloat layer;
     };
 
+    /* Compact form of <PosNormColVertex>, used when vertices are quantized */
+    struct QuantizedVertex {
+        // Position Data, layer in w (see QUANTIZED_LAYER_SCALE)
+        GLshort pos[4];
+        // Normal Data, w unused
+        GLbyte norm[4];
+        // UV Data
+        GLushort texcoord[2];
+        // Color Data
+        GLuint abgr;
+
+        QuantizedVertex(const glm::vec3& _pos, const glm::vec3& _norm, const glm::vec2& _texcoord, GLuint _abgr, GLfloat _layer) :
+            pos{ quantizePosition(_pos.x), quantizePosition(_pos.y), quantizePosition(_pos.z), quantizeLayer(_layer) },
+            norm{ quantizeNormal(_norm.x), quantizeNormal(_norm.y), quantizeNormal(_norm.z), 0 },
+            texcoord{ quantizeUnit(_texcoord.x), quantizeUnit(_texcoord.y) },
+            abgr(_abgr) {}
+    };
+
     virtual void constructVertexLayout() override;
     virtual void constructShaderProgram() override;
-    virtual void buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const override;
-    virtual void* parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) override;
+    virtual void buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const override;
+    virtual void buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const override;
+    virtual void buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const override;
+    virtual void* parseStyleParams(const StyleParamMap& _styleParamMap) override;
 
     typedef TypedMesh<PosNormColVertex> Mesh;
+    typedef TypedMesh<QuantizedVertex> QuantizedMesh;
 
     virtual VboMesh* newMesh() const override {
+        if (m_quantizeVertices) {
+            return new QuantizedMesh(m_vertexLayout, m_drawMode);
+        }
         return new Mesh(m_vertexLayout, m_drawMode);
     };
 
-    std::unordered_map<std::string, StyleParams*> m_styleParamCache;
-    std::mutex m_cacheMutex;
+    /* Build line and polygon geometry into a mesh of vertex type <V> */
+    template<class V>
+    void buildLineVertices(Line& _line, VboMesh& _mesh) const;
+    template<class V>
+    void buildPolygonVertices(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const;
+
+    /* Storage for the parameters parsed for each layer, referenced from <m_styleParams> */
+    std::vector<std::unique_ptr<StyleParams>> m_parsedParams;
 
 public:
 
     PolygonStyle(GLenum _drawMode = GL_TRIANGLES);
     PolygonStyle(std::string _name, GLenum _drawMode = GL_TRIANGLES);
 
-    virtual ~PolygonStyle() {
-        for(auto& styleParam : m_styleParamCache) {
-            delete styleParam.second;
-        }
-        m_styleParamCache.clear();
-    }
+    virtual ~PolygonStyle() {}
 };
@@ -9,6 +9,17 @@ PolylineStyle::PolylineStyle(std::string _name, GLenum _drawMode) : Style(_name,
 void PolylineStyle::constructVertexLayout() {
 
     // TODO: Ideally this would be in the same location as the struct that it basically describes
+    if (m_quantizeVertices) {
+        m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
+            {"a_position", 4, GL_SHORT, false, 0},
+            {"a_texcoord", 2, GL_UNSIGNED_SHORT, true, 0},
+            {"a_extrudeNormal", 4, GL_BYTE, false, 0},
+            {"a_extrudeWidth", 1, GL_FLOAT, false, 0},
+            {"a_color", 4, GL_UNSIGNED_BYTE, true, 0}
+        }));
+        return;
+    }
+
     m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
         {"a_position", 3, GL_FLOAT, false, 0},
         {"a_texcoord", 2, GL_FLOAT, false, 0},
@@ -28,11 +39,7 @@ void PolylineStyle::constructShaderProgram() {
     m_shaderProgram->setSourceStrings(fragShaderSrcStr, vertShaderSrcStr);
 }
 
-void* PolylineStyle::parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) {
-
-    if(m_styleParamCache.find(_layerNameID) != m_styleParamCache.end()) {
-        return static_cast<void*>(m_styleParamCache.at(_layerNameID));
-    }
+void* PolylineStyle::parseStyleParams(const StyleParamMap& _styleParamMap) {
 
     StyleParams* params = new StyleParams();
 
@@ -87,37 +94,58 @@ void* PolylineStyle::parseStyleParams(const std::string& _layerNameID, const Sty
         else if(joinStr == "round") { params->outlineJoin = JoinTypes::ROUND; }
     }
 
-    {
-        std::lock_guard<std::mutex> lock(m_cacheMutex);
-        m_styleParamCache.emplace(_layerNameID, params);
-    }
+    m_parsedParams.emplace_back(params);
 
     return static_cast<void*>(params);
 }
 
-void PolylineStyle::buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolylineStyle::buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
     // No-op
 }
 
-void PolylineStyle::buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
-    std::vector<PosNormEnormColVertex> vertices;
+void PolylineStyle::buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
+    if (m_quantizeVertices) {
+        buildLineVertices<QuantizedVertex>(_line, _styleParam, _props, _mesh, _tile);
+    } else {
+        buildLineVertices<PosNormEnormColVertex>(_line, _styleParam, _props, _mesh, _tile);
+    }
+}
+
+float PolylineStyle::boundsPadding(void* _styleParams) const {
+
+    // polyline.vs extrudes vertices by twice their half width at the zoom of the tile, and outlines are
+    // built with the half width of the line plus half of the outline width
+    StyleParams* params = static_cast<StyleParams*>(_styleParams);
+    float halfWidth = params->width * .5f;
+
+    if (params->outlineOn) {
+        halfWidth += params->outlineWidth * .5f;
+    }
+
+    return 2.f * halfWidth;
+}
+
+template<class V>
+void PolylineStyle::buildLineVertices(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
+    auto& mesh = static_cast<TypedMesh<V>&>(_mesh);
 
     StyleParams* params = static_cast<StyleParams*>(_styleParam);
     GLuint abgr = params->color;
 
     if (Tangram::getDebugFlag(Tangram::DebugFlags::PROXY_COLORS)) {
-        abgr = abgr << (int(_props.numericProps["zoom"]) % 6);
+        abgr = abgr << (_tile.getID().z % 6);
     }
 
-    GLfloat layer = _props.numericProps["sort_key"] + params->order;
+    GLfloat layer = _props.getNumeric("sort_key") + params->order;
     float halfWidth = params->width * .5f;
 
-    PolyLineBuilder builder {
+    auto builder = makePolyLineBuilder(
         [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
-            vertices.push_back({ coord, uv, normal, halfWidth, abgr, layer });
+            mesh.pushVertex(V{ coord, uv, normal, halfWidth, abgr, layer });
         },
+        [&](size_t sizeHint){ mesh.reserveVertices(sizeHint); },
         PolyLineOptions(params->cap, params->join)
-    };
+    );
 
     Builders::buildPolyLine(_line, builder);
 
@@ -134,23 +162,26 @@ void PolylineStyle::buildLine(Line& _line, void* _styleParam, Properties& _props
         } else {
             // re-use indices from original line
             size_t oldSize = builder.indices.size();
-            size_t offset = vertices.size();
+            size_t offset = mesh.pendingVertices();
             builder.indices.reserve(2 * oldSize);
+            mesh.reserveVertices(2 * offset);
 
             for(size_t i = 0; i < oldSize; i++) {
                  builder.indices.push_back(offset + builder.indices[i]);
             }
             for (size_t i = 0; i < offset; i++) {
-                const auto& v = vertices[i];
-                vertices.push_back({ v.pos, v.texcoord, v.enorm, halfWidth, abgrOutline, layer - 1.f });
+                V v = mesh.getPendingVertex(i);
+                v.ewidth = halfWidth;
+                v.abgr = abgrOutline;
+                setLayer(v, layer - 1.f);
+                mesh.pushVertex(v);
             }
         }
     }
 
-    auto& mesh = static_cast<PolylineStyle::Mesh&>(_mesh);
-    mesh.addVertices(std::move(vertices), std::move(builder.indices));
+    mesh.addIndices(builder.indices);
 }
 
-void PolylineStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void PolylineStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
     // No-op
 }
@@ -3,7 +3,7 @@
 #include "style.h"
 #include "typedMesh.h"
 
-#include <mutex>
+#include <memory>
 
 class PolylineStyle : public Style {
 
@@ -36,31 +36,57 @@ protected:
         GLfloat layer;
     };
 
+    /* Compact form of <PosNormEnormColVertex>, used when vertices are quantized */
+    struct QuantizedVertex {
+        // Position Data, layer in w (see QUANTIZED_LAYER_SCALE)
+        GLshort pos[4];
+        // UV Data
+        GLushort texcoord[2];
+        // Extrude Normals Data, zw unused
+        GLbyte enorm[4];
+        GLfloat ewidth;
+        // Color Data
+        GLuint abgr;
+
+        QuantizedVertex(const glm::vec3& _pos, const glm::vec2& _texcoord, const glm::vec2& _enorm, GLfloat _ewidth, GLuint _abgr, GLfloat _layer) :
+            pos{ quantizePosition(_pos.x), quantizePosition(_pos.y), quantizePosition(_pos.z), quantizeLayer(_layer) },
+            texcoord{ quantizeUnit(_texcoord.x), quantizeUnit(_texcoord.y) },
+            enorm{ quantizeExtrusion(_enorm.x), quantizeExtrusion(_enorm.y), 0, 0 },
+            ewidth(_ewidth), abgr(_abgr) {}
+    };
+
+    static void setLayer(PosNormEnormColVertex& _vertex, GLfloat _layer) { _vertex.layer = _layer; }
+    static void setLayer(QuantizedVertex& _vertex, GLfloat _layer) { _vertex.pos[3] = quantizeLayer(_layer); }
+
     virtual void constructVertexLayout() override;
     virtual void constructShaderProgram() override;
-    virtual void buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const override;
-    virtual void buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const override;
-    virtual void* parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) override;
+    virtual void buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const override;
+    virtual void buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const override;
+    virtual void buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const override;
+    virtual void* parseStyleParams(const StyleParamMap& _styleParamMap) override;
+    virtual float boundsPadding(void* _styleParams) const override;
 
     typedef TypedMesh<PosNormEnormColVertex> Mesh;
+    typedef TypedMesh<QuantizedVertex> QuantizedMesh;
 
     virtual VboMesh* newMesh() const override {
+        if (m_quantizeVertices) {
+            return new QuantizedMesh(m_vertexLayout, m_drawMode);
+        }
         return new Mesh(m_vertexLayout, m_drawMode);
     };
 
-    std::unordered_map<std::string, StyleParams*> m_styleParamCache;
-    std::mutex m_cacheMutex;
+    /* Build line geometry into a mesh of vertex type <V> */
+    template<class V>
+    void buildLineVertices(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const;
+
+    /* Storage for the parameters parsed for each layer, referenced from <m_styleParams> */
+    std::vector<std::unique_ptr<StyleParams>> m_parsedParams;
 
 public:
 
     PolylineStyle(GLenum _drawMode = GL_TRIANGLES);
     PolylineStyle(std::string _name, GLenum _drawMode = GL_TRIANGLES);
 
-    virtual ~PolylineStyle() {
-        for(auto& styleParam : m_styleParamCache) {
-            delete styleParam.second;
-        }
-        m_styleParamCache.clear();
-    }
+    virtual ~PolylineStyle() {}
 };
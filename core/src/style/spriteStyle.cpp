@@ -29,19 +29,19 @@ void SpriteStyle::constructShaderProgram() {
     m_texture = std::shared_ptr<Texture>(new Texture("mapzen-logo.png"));
 }
 
-void* SpriteStyle::parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) {
+void* SpriteStyle::parseStyleParams(const StyleParamMap& _styleParamMap) {
     return nullptr;
 }
 
-void SpriteStyle::buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void SpriteStyle::buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
 
 }
 
-void SpriteStyle::buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void SpriteStyle::buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
 
 }
 
-void SpriteStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const {
+void SpriteStyle::buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
 
 }
 
@@ -51,7 +51,7 @@ void SpriteStyle::onBeginDrawFrame(const std::shared_ptr<View>& _view, const std
     m_shaderProgram->setUniformi("u_tex", 0);
 }
 
-void SpriteStyle::addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) {
+void SpriteStyle::addData(const std::vector<StyledFeature>& _features, MapTile& _tile, const MapProjection& _mapProjection) {
 
     Mesh* mesh = new Mesh(m_vertexLayout, m_drawMode);
 
@@ -68,6 +68,7 @@ void SpriteStyle::addData(TileData& _data, MapTile& _tile, const MapProjection&
     mesh->addVertices(std::move(vertices), { 0, 1, 2, 2, 3, 0 });
     mesh->compileVertexBuffer();
 
+    _tile.extendBounds(glm::vec3(-size, -size, 0.f), glm::vec3(size, size, 0.f));
     _tile.addGeometry(*this, std::unique_ptr<VboMesh>(mesh));
 
 }
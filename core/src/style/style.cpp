@@ -2,6 +2,9 @@
 #include "scene/scene.h"
 #include "util/vboMesh.h"
 #include <sstream>
+#include <limits>
+#include <algorithm>
+#include <atomic>
 
 Style::Style(std::string _name, GLenum _drawMode) : m_name(_name), m_drawMode(_drawMode) {
 }
@@ -26,6 +29,34 @@ uint32_t Style::parseColorProp(const std::string& _colorPropStr) {
     return color;
 }
 
+GLshort Style::quantizePosition(float _value) {
+    return (GLshort)glm::clamp(roundf(_value * QUANTIZED_POSITION_SCALE), -32768.f, 32767.f);
+}
+
+GLshort Style::quantizeLayer(float _value) {
+    float layer = roundf(_value * QUANTIZED_LAYER_SCALE);
+    if (layer < -32768.f || layer > 32767.f) {
+        // Called from every tile worker; warn only once
+        static std::atomic<bool> warned(false);
+        if (!warned.exchange(true)) {
+            logMsg("WARNING: Layer %f is out of the quantized range, layers are clamped\n", _value);
+        }
+    }
+    return (GLshort)glm::clamp(layer, -32768.f, 32767.f);
+}
+
+GLbyte Style::quantizeExtrusion(float _value) {
+    return (GLbyte)glm::clamp(roundf(_value * QUANTIZED_EXTRUDE_SCALE), -128.f, 127.f);
+}
+
+GLbyte Style::quantizeNormal(float _value) {
+    return (GLbyte)glm::clamp(roundf(_value * 127.f), -127.f, 127.f);
+}
+
+GLushort Style::quantizeUnit(float _value) {
+    return (GLushort)glm::clamp(roundf(_value * 65535.f), 0.f, 65535.f);
+}
+
 void Style::build(const std::vector<std::unique_ptr<Light>>& _lights) {
 
     constructVertexLayout();
@@ -42,6 +73,13 @@ void Style::build(const std::vector<std::unique_ptr<Light>>& _lights) {
             break;
     }
 
+    if (m_quantizeVertices) {
+        m_shaderProgram->addSourceBlock("defines", "#define TANGRAM_QUANTIZED_VERTICES\n"
+                                        "#define TANGRAM_QUANTIZED_POSITION_SCALE " + std::to_string(QUANTIZED_POSITION_SCALE) + "\n"
+                                        "#define TANGRAM_QUANTIZED_EXTRUDE_SCALE " + std::to_string(QUANTIZED_EXTRUDE_SCALE) + "\n"
+                                        "#define TANGRAM_QUANTIZED_LAYER_SCALE " + std::to_string(QUANTIZED_LAYER_SCALE) + "\n", false);
+    }
+
     m_material->injectOnProgram(m_shaderProgram);
 
     for (auto& light : _lights) {
@@ -62,72 +100,123 @@ void Style::setLightingType(LightingType _type){
 
 }
 
-void Style::addLayer(const std::pair<std::string, StyleParamMap>&& _layer) {
+int Style::addLayer(StyleLayer&& _layer) {
+
+    _layer.paramsID = m_styleParams.size();
+    m_styleParams.push_back(parseStyleParams(_layer.params));
 
     m_layers.push_back(std::move(_layer));
 
+    return m_layers.size() - 1;
+
 }
 
-void Style::addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection) {
+void Style::addData(const std::vector<StyledFeature>& _features, MapTile& _tile, const MapProjection& _mapProjection) {
+
+    if (_features.empty()) {
+        return;
+    }
+
     onBeginBuildTile(_tile);
 
     std::shared_ptr<VboMesh> mesh(newMesh());
-
-    for (auto& layer : _data.layers) {
-
-        // Skip any layers that this style doesn't have a rule for
-        auto it = m_layers.begin();
-        while (it != m_layers.end() && it->first != layer.name) { ++it; }
-        if (it == m_layers.end()) { continue; }
-
-        // Loop over all features
-        for (auto& feature : layer.features) {
-
-            /*
-             * TODO: do filter evaluation for each feature for sublayer!
-             *     construct a unique ID for a the set of filters matched
-             *     use this ID pass to the style's parseStyleParams method to construct styleParam cache
-             *     NOTE: for the time being use layerName as ID for cache
-             */
-
-            feature.props.numericProps["zoom"] = _tile.getID().z;
-
-            switch (feature.geometryType) {
-                case GeometryType::POINTS:
-                    // Build points
-                    for (auto& point : feature.points) {
-                        buildPoint(point, parseStyleParams(it->first, it->second), feature.props, *mesh);
-                    }
-                    break;
-                case GeometryType::LINES:
-                    // Build lines
-                    for (auto& line : feature.lines) {
-                        buildLine(line, parseStyleParams(it->first, it->second), feature.props, *mesh);
-                    }
-                    break;
-                case GeometryType::POLYGONS:
-                    // Build polygons
-                    for (auto& polygon : feature.polygons) {
-                        buildPolygon(polygon, parseStyleParams(it->first, it->second), feature.props, *mesh);
-                    }
-                    break;
-                default:
-                    break;
-            }
+    mesh->setRetainData(m_retainVertexData);
+    mesh->setOptimizeVertexCache(m_optimizeVertexCache);
+
+    // Extent of the features in tile units, including extrusion heights, and the largest reach of their
+    // meshes beyond it (see boundsPadding())
+    glm::vec3 boundsMin(std::numeric_limits<float>::max());
+    glm::vec3 boundsMax(std::numeric_limits<float>::lowest());
+    float padding = 0.f;
+
+    for (const auto& styled : _features) {
+
+        Feature& feature = *styled.feature;
+        void* params = m_styleParams[m_layers[styled.rule].paramsID];
+
+        extendBounds(feature, boundsMin, boundsMax);
+        padding = std::max(padding, boundsPadding(params));
+
+        switch (feature.geometryType) {
+            case GeometryType::POINTS:
+                // Build points
+                for (auto& point : feature.points) {
+                    buildPoint(point, params, feature.props, *mesh, _tile);
+                }
+                break;
+            case GeometryType::LINES:
+                // Build lines
+                for (auto& line : feature.lines) {
+                    buildLine(line, params, feature.props, *mesh, _tile);
+                }
+                break;
+            case GeometryType::POLYGONS:
+                // Build polygons
+                for (auto& polygon : feature.polygons) {
+                    buildPolygon(polygon, params, feature.props, *mesh, _tile);
+                }
+                break;
+            default:
+                break;
         }
     }
 
     onEndBuildTile(_tile, mesh);
 
+    if (m_quantizeVertices) {
+        // Quantized positions are clamped, which folds geometry beyond the range onto its boundary
+        float range = QUANTIZED_POSITION_RANGE;
+        if (boundsMin.x < -range || boundsMin.y < -range || boundsMin.z < -range ||
+            boundsMax.x > range || boundsMax.y > range || boundsMax.z > range) {
+            const TileID& id = _tile.getID();
+            logMsg("WARNING: Geometry of style '%s' in tile [%d, %d, %d] exceeds the quantized range of +/-%.0f tile units\n",
+                   m_name.c_str(), id.z, id.x, id.y, range);
+        }
+    }
+
     if (mesh->numVertices() == 0) {
         mesh.reset();
     } else {
+        // Arenas are only attached to meshes which will be uploaded, so that a mesh released on this
+        // thread never touches them; they are GL thread only
+        mesh->setBufferArenas(m_vertexArena, m_indexArena);
         mesh->compileVertexBuffer();
 
+        _tile.extendBounds(boundsMin, boundsMax, padding);
         _tile.addGeometry(*this, mesh);
     }
 }
 
+void Style::extendBounds(const Feature& _feature, glm::vec3& _min, glm::vec3& _max) {
+
+    auto extend = [&](const Point& _point) {
+        _min = glm::min(_min, _point);
+        _max = glm::max(_max, _point);
+    };
+
+    for (const auto& point : _feature.points) {
+        extend(point);
+    }
+    for (const auto& line : _feature.lines) {
+        for (const auto& point : line) { extend(point); }
+    }
+    for (const auto& polygon : _feature.polygons) {
+        for (const auto& ring : polygon) {
+            for (const auto& point : ring) { extend(point); }
+        }
+    }
+
+    // Extruded features reach from their min_height to their height
+    const auto& numericProps = _feature.props.numericProps;
+    for (const char* key : { "height", "min_height" }) {
+        auto it = numericProps.find(key);
+        if (it != numericProps.end()) {
+            _min.z = std::min(_min.z, it->second);
+            _max.z = std::max(_max.z, it->second);
+        }
+    }
+}
+
 void Style::onBeginDrawFrame(const std::shared_ptr<View>& _view, const std::shared_ptr<Scene>& _scene) {
 
     m_material->setupProgram(m_shaderProgram);
@@ -137,7 +226,8 @@ void Style::onBeginDrawFrame(const std::shared_ptr<View>& _view, const std::shar
         light->setupProgram(_view, m_shaderProgram);
     }
 
-    m_shaderProgram->setUniformf("u_zoom", _view->getZoom());
+    static UniformLocation s_uZoom("u_zoom");
+    m_shaderProgram->setUniformf(s_uZoom, _view->getZoom());
 
 }
 
@@ -13,8 +13,10 @@
 #include "util/shaderProgram.h"
 #include "util/mapProjection.h"
 #include "util/builders.h"
+#include "util/bufferArena.h"
 #include "view/view.h"
 #include "styleParamMap.h"
+#include "data/filters.h"
 #include "csscolorparser.hpp"
 
 
@@ -26,6 +28,21 @@ enum class LightingType : char {
 
 class Scene;
 
+/* A data layer to which a style applies, with the style parameters to use for it
+ * and the compiled filter that its features must pass to be built */
+struct StyleLayer {
+    std::string name;
+    StyleParamMap params;
+    Tangram::CompiledFilter filter;
+    int paramsID; // index of the parsed parameters of this layer in the style's parameter table, set by addLayer
+};
+
+/* A feature routed to a style, with the index of the style's layer rule that it matched */
+struct StyledFeature {
+    Feature* feature;
+    int rule;
+};
+
 /* Means of constructing and rendering map geometry
  *
  * A Style defines a way to
@@ -46,6 +63,9 @@ protected:
     /* Unique name for a style instance */
     std::string m_name;
 
+    /* Index of this style in its <Scene>, assigned when the style is added to it */
+    size_t m_id = 0;
+
     /* <ShaderProgram> used to draw meshes using this style */
     std::shared_ptr<ShaderProgram> m_shaderProgram = std::make_shared<ShaderProgram>();
 
@@ -61,10 +81,26 @@ protected:
     /* Draw mode to pass into <VboMesh>es created with this style */
     GLenum m_drawMode;
 
-    /* Set of strings defining which data layers this style applies to,
-     * along with the style paramter map corresponding to these data layers,
-     * to be parsed explicitly by styles for their style parameters*/
-    std::vector< std::pair<std::string, StyleParamMap> > m_layers;
+    /* Whether <VboMesh>es built with this style keep their vertex data in memory after upload */
+    bool m_retainVertexData = true;
+
+    /* Whether this style builds meshes in its compact fixed-point vertex format, see setQuantizeVertices() */
+    bool m_quantizeVertices = false;
+
+    /* Whether meshes built with this style are reordered for the GPU vertex cache before upload */
+    bool m_optimizeVertexCache = false;
+
+    /* <BufferArena>s from which the vertex and index buffers of the static meshes of all tiles using this style are allocated */
+    std::shared_ptr<BufferArena> m_vertexArena = std::make_shared<BufferArena>(GL_ARRAY_BUFFER);
+    std::shared_ptr<BufferArena> m_indexArena = std::make_shared<BufferArena>(GL_ELEMENT_ARRAY_BUFFER);
+
+    /* Set of data layers this style applies to, along with the style paramter map corresponding to 
+     * these data layers, to be parsed explicitly by styles for their style parameters, and their filters */
+    std::vector<StyleLayer> m_layers;
+
+    /* Table of parsed style parameters indexed by <StyleLayer::paramsID>; entries are parsed once when layers
+     * are added at scene load, owned by the style subclass which parsed them, and only read by worker threads */
+    std::vector<void*> m_styleParams;
 
     /* Create <VertexLayout> corresponding to this style; subclasses must implement this and call it on construction */
     virtual void constructVertexLayout() = 0;
@@ -73,21 +109,44 @@ protected:
     virtual void constructShaderProgram() = 0;
 
     /* Build styled vertex data for point geometry and add it to the given <VboMesh> */
-    virtual void buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh) const = 0;
+    virtual void buildPoint(Point& _point, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const = 0;
 
     /* Build styled vertex data for line geometry and add it to the given <VboMesh> */
-    virtual void buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh) const = 0;
+    virtual void buildLine(Line& _line, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const = 0;
 
     /* Build styled vertex data for polygon geometry and add it to the given <VboMesh> */
-    virtual void buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh) const = 0;
+    virtual void buildPolygon(Polygon& _polygon, void* _styleParam, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const = 0;
 
-    /* Parse StyleParamMap to apt Style property parameters, and puts in the styleParamCache
-     * NOTE: layerNameID will be replaced by unique ID for a set of filter matches*/
-    virtual void* parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) = 0;
+    /* Parse StyleParamMap to apt Style property parameters; called once for each layer added to the style,
+     * the returned parameters must stay valid and unchanged for the lifetime of the style */
+    virtual void* parseStyleParams(const StyleParamMap& _styleParamMap) = 0;
 
     /* parse color properties */
     static uint32_t parseColorProp(const std::string& _colorPropStr) ;
 
+    /* Fixed-point encodings for quantized vertex formats; shaders decode them when TANGRAM_QUANTIZED_VERTICES
+     * is defined, see setQuantizeVertices() */
+    constexpr static float QUANTIZED_POSITION_SCALE = 4096.f; // Positions in 1/4096 tile units, within +/-8 units
+    constexpr static float QUANTIZED_EXTRUDE_SCALE = 32.f; // Extrusion vectors in 1/32 units, within +/-4 units
+    constexpr static float QUANTIZED_LAYER_SCALE = 8.f; // Layers (sort_key + order) in 1/8 steps, within +/-4096
+    constexpr static float QUANTIZED_POSITION_RANGE = 32767.f / QUANTIZED_POSITION_SCALE; // Largest position in tile units
+
+    static GLshort quantizePosition(float _value);
+    static GLshort quantizeLayer(float _value);
+    static GLbyte quantizeExtrusion(float _value);
+    static GLbyte quantizeNormal(float _value); // [-1, 1] to a normalized GL_BYTE
+    static GLushort quantizeUnit(float _value); // [0, 1] to a normalized GL_UNSIGNED_SHORT
+
+    /* Extends the box [_min, _max] to contain the geometry of _feature, including its extrusion */
+    static void extendBounds(const Feature& _feature, glm::vec3& _min, glm::vec3& _max);
+
+    /*
+     * Returns how far in tile units the meshes built with _styleParams may reach beyond the coordinates of
+     * their features in x and y at the zoom of their tile (e.g. the half width of lines); 0 by default.
+     * <MapTile::isInFrustum()> scales it for the zoom of the view
+     */
+    virtual float boundsPadding(void* _styleParams) const { return 0.f; }
+
     /* Perform any needed setup to process the data for a tile */
     virtual void onBeginBuildTile(MapTile& _tile) const;
 
@@ -106,11 +165,11 @@ public:
     /* Make this style ready to be used (call after all needed properties are set) */
     virtual void build(const std::vector<std::unique_ptr<Light>>& _lights);
 
-    /* Add layers to which this style will apply */
-    virtual void addLayer(const std::pair<std::string, StyleParamMap>&& _layer);
+    /* Add layers to which this style will apply, returns the index of the new layer rule */
+    virtual int addLayer(StyleLayer&& _layer);
 
-    /* Add styled geometry from the given <TileData> object to the given <MapTile> */
-    virtual void addData(TileData& _data, MapTile& _tile, const MapProjection& _mapProjection);
+    /* Add styled geometry for the features routed to this style to the given <MapTile> */
+    virtual void addData(const std::vector<StyledFeature>& _features, MapTile& _tile, const MapProjection& _mapProjection);
 
     /* Perform any setup needed before drawing each frame */
     virtual void onBeginDrawFrame(const std::shared_ptr<View>& _view, const std::shared_ptr<Scene>& _scene);
@@ -124,10 +183,31 @@ public:
 
     void setPixelScale(float _pixelScale) { m_pixelScale = _pixelScale; }
 
+    /* Sets whether meshes of this style keep a CPU copy of their vertices after upload; without it, tiles are
+     * rebuilt from their data after the GL context is lost */
+    void setRetainVertexData(bool _retain) { m_retainVertexData = _retain; }
+
+    /* Sets whether this style uses a compact vertex format, with positions as shorts, normals and extrusions as
+     * bytes and texture coordinates as normalized shorts; positions must stay within 8 tile units of the tile
+     * center (other values are clamped). Only styles which have such a format support this; set before build() */
+    void setQuantizeVertices(bool _quantize) { m_quantizeVertices = _quantize; }
+
+    /* Sets whether the triangles and vertices of meshes built with this style are reordered for the GPU
+     * vertex cache when the tile is built; the cache miss ratio before and after is accumulated over all
+     * meshes (see <VboMesh::getVertexCacheStats()>) and logged on teardown */
+    void setOptimizeVertexCache(bool _optimize) { m_optimizeVertexCache = _optimize; }
+
     std::shared_ptr<Material> getMaterial() { return m_material; }
 
     std::shared_ptr<ShaderProgram> getShaderProgram() const { return m_shaderProgram; }
 
     const std::string& getName() const { return m_name; }
 
+    /* Sets the style ID; called by <Scene::addStyle()>, IDs are dense from 0 in the order styles are added */
+    void setID(size_t _id) { m_id = _id; }
+
+    size_t getID() const { return m_id; }
+
+    const std::vector<StyleLayer>& getLayers() const { return m_layers; }
+
 };
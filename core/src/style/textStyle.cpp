@@ -38,7 +38,7 @@ void TextStyle::constructShaderProgram() {
     m_shaderProgram->addSourceBlock("defines", defines);
 }
 
-void* TextStyle::parseStyleParams(const std::string& _layerNameID, const StyleParamMap& _styleParamMap) {
+void* TextStyle::parseStyleParams(const StyleParamMap& _styleParamMap) {
     return nullptr;
 }
 
@@ -58,15 +58,15 @@ void TextStyle::addVertices(TextBuffer& _buffer, VboMesh& _mesh) const {
     }
 }
 
-void TextStyle::buildPoint(Point& _point, void* _styleParams, Properties& _props, VboMesh& _mesh) const {
+void TextStyle::buildPoint(Point& _point, void* _styleParams, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
     for (auto prop : _props.stringProps) {
         if (prop.first == "name") {
-            m_labels->addLabel(*TextStyle::s_processedTile, m_name, { glm::vec2(_point), glm::vec2(_point) }, prop.second, Label::Type::POINT);
+            m_labels->addLabel(*TextStyle::s_processedTile, m_id, { glm::vec2(_point), glm::vec2(_point) }, prop.second, Label::Type::POINT);
         }
     }
 }
 
-void TextStyle::buildLine(Line& _line, void* _styleParams, Properties& _props, VboMesh& _mesh) const {
+void TextStyle::buildLine(Line& _line, void* _styleParams, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
     int lineLength = _line.size();
     int skipOffset = floor(lineLength / 2);
     float minLength = 0.15; // default, probably need some more thoughts
@@ -85,13 +85,13 @@ void TextStyle::buildLine(Line& _line, void* _styleParams, Properties& _props, V
                     continue;
                 }
                 
-                m_labels->addLabel(*TextStyle::s_processedTile, m_name, { p1, p2 }, prop.second, Label::Type::LINE);
+                m_labels->addLabel(*TextStyle::s_processedTile, m_id, { p1, p2 }, prop.second, Label::Type::LINE);
             }
         }
     }
 }
 
-void TextStyle::buildPolygon(Polygon& _polygon, void* _styleParams, Properties& _props, VboMesh& _mesh) const {
+void TextStyle::buildPolygon(Polygon& _polygon, void* _styleParams, Properties& _props, VboMesh& _mesh, const MapTile& _tile) const {
     glm::vec3 centroid;
     int n = 0;
 
@@ -107,7 +107,7 @@ void TextStyle::buildPolygon(Polygon& _polygon, void* _styleParams, Properties&
 
     for (auto prop : _props.stringProps) {
         if (prop.first == "name") {
-            m_labels->addLabel(*TextStyle::s_processedTile, m_name, { glm::vec2(centroid), glm::vec2(centroid) }, prop.second, Label::Type::POINT);
+            m_labels->addLabel(*TextStyle::s_processedTile, m_id, { glm::vec2(centroid), glm::vec2(centroid) }, prop.second, Label::Type::POINT);
         }
     }
 }
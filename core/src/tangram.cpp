@@ -4,6 +4,7 @@
 #include <utility>
 #include <cmath>
 #include <set>
+#include <vector>
 
 #include "platform.h"
 #include "scene/scene.h"
@@ -14,10 +15,13 @@
 #include "style/spriteStyle.h"
 #include "style/textStyle.h"
 #include "text/fontContext.h"
+#include "tile/drawList.h"
 #include "tile/tileManager.h"
+#include "tile/proxyMask.h"
 #include "util/error.h"
 #include "util/skybox.h"
 #include "util/tileID.h"
+#include "util/vboMesh.h"
 #include "view/view.h"
 
 namespace Tangram {
@@ -29,6 +33,9 @@ namespace Tangram {
     std::shared_ptr<FontContext> m_ftContext;
     std::shared_ptr<DebugStyle> m_debugStyle;
     std::shared_ptr<Skybox> m_skybox;
+    std::vector<MapTile*> m_drawnTiles; // Loaded tiles of the current frame which are within the view frustum
+    std::vector<MapTile*> m_drawnProxyTiles; // Proxy tiles of the current frame which are within the view frustum
+    DrawList m_drawList; // Meshes of the drawn tiles, sorted for drawing
 
     static float g_time = 0.0;
     static unsigned long g_flags = 0;
@@ -82,6 +89,9 @@ namespace Tangram {
         glCullFace(GL_BACK);
         glClearColor(0.3f, 0.3f, 0.3f, 1.0f);
 
+        VboMesh::detectGLSupport();
+        ProxyMask::init();
+
         while (Error::hadGlError("Tangram::initialize()")) {}
 
         logMsg("finish initialize\n");
@@ -144,7 +154,8 @@ namespace Tangram {
                 }
             }
 
-            if (Label::s_needUpdate) {
+            // Keep rendering while loaded tiles wait for upload
+            if (Label::s_needUpdate || m_tileManager->hasPendingUploads()) {
                 requestRender();
             }
         }
@@ -157,22 +168,36 @@ namespace Tangram {
     void render() {
 
         // Set up openGL for new frame
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // Loop over all styles
-        for (const auto& style : m_scene->getStyles()) {
-            style->onBeginDrawFrame(m_view, m_scene);
-
-            // Loop over all tiles in m_tileSet
-            for (const auto& mapIDandTile : m_tileManager->getVisibleTiles()) {
-                const std::shared_ptr<MapTile>& tile = mapIDandTile.second;
-                if (tile->hasGeometry()) {
-                    // Draw tile!
-                    tile->draw(*style, *m_view);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | (ProxyMask::isAvailable() ? GL_STENCIL_BUFFER_BIT : 0));
+
+        // Cull tiles outside of the view frustum once for all styles
+        m_drawnTiles.clear();
+        m_drawnProxyTiles.clear();
+
+        for (const auto& mapIDandTile : m_tileManager->getVisibleTiles()) {
+            const std::shared_ptr<MapTile>& tile = mapIDandTile.second;
+            if (tile->hasGeometry() && tile->isInFrustum(*m_view)) {
+                if (tile->getProxyCounter() > 0) {
+                    m_drawnProxyTiles.push_back(tile.get());
+                } else {
+                    m_drawnTiles.push_back(tile.get());
                 }
             }
+        }
+
+        // Restrict proxy tiles to the area not covered by loaded tiles
+        bool maskProxies = ProxyMask::isAvailable() && !m_drawnProxyTiles.empty() && !m_drawnTiles.empty();
+
+        if (maskProxies) {
+            ProxyMask::write(m_drawnTiles, *m_view);
+        }
+
+        // Draw the meshes of all styles, computing the matrices of each tile once
+        m_drawList.build(m_drawnTiles, m_drawnProxyTiles, *m_scene, *m_view);
+        m_drawList.draw(m_scene, m_view, maskProxies);
 
-            style->onEndDrawFrame();
+        if (maskProxies) {
+            ProxyMask::end();
         }
 
         m_skybox->draw(*m_view);
@@ -222,6 +247,14 @@ namespace Tangram {
 
     }
 
+    void setUploadBudget(unsigned int _bytes, float _milliseconds) {
+
+        if (m_tileManager) {
+            m_tileManager->setUploadBudget(_bytes, _milliseconds);
+        }
+
+    }
+
     void handleTapGesture(float _posX, float _posY) {
 
         float viewCenterX = 0.5f * m_view->getWidth();
@@ -305,6 +338,15 @@ namespace Tangram {
         m_tileManager.reset();
         m_scene.reset();
         m_view.reset();
+
+        // Report the vertex cache optimization of the session (see Style::setOptimizeVertexCache())
+        float acmrBefore, acmrAfter;
+        uint64_t triangles = VboMesh::getVertexCacheStats(acmrBefore, acmrAfter);
+        if (triangles > 0) {
+            logMsg("NOTICE: Vertex cache optimized %llu triangles, ACMR %.3f -> %.3f\n",
+                   (unsigned long long)triangles, acmrBefore, acmrAfter);
+            VboMesh::resetVertexCacheStats();
+        }
     }
 
     void onContextDestroyed() {
@@ -320,6 +362,11 @@ namespace Tangram {
         // Buffer objects are invalidated and re-uploaded the next time they are used
         VboMesh::invalidateAllVBOs();
 
+        // Tiles whose meshes released their vertex data after upload are built again
+        if (m_tileManager) {
+            m_tileManager->rebuildLostTiles();
+        }
+
     }
 
 }
@@ -43,6 +43,10 @@ namespace Tangram {
     // Set the ratio of hardware pixels to logical pixels (defaults to 1.0)
     void setPixelScale(float _pixelsPerPoint);
 
+    // Set the bytes and milliseconds spent uploading newly loaded tiles to the GPU per frame, 0 for no limit
+    // (defaults to 1MB and 4ms)
+    void setUploadBudget(unsigned int _bytes, float _milliseconds);
+
     // Respond to a tap at the given screen coordinates (x right, y down)
     void handleTapGesture(float _posX, float _posY);
 
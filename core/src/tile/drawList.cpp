@@ -0,0 +1,105 @@
+#include "drawList.h"
+
+#include "scene/scene.h"
+#include "style/style.h"
+#include "tile/mapTile.h"
+#include "tile/proxyMask.h"
+#include "util/shaderProgram.h"
+#include "util/vboMesh.h"
+#include "view/view.h"
+
+#include "glm/gtc/type_ptr.hpp"
+
+#include <algorithm>
+
+// Uniforms set for every tile drawn
+static UniformLocation s_uModelView("u_modelView");
+static UniformLocation s_uModelViewProj("u_modelViewProj");
+static UniformLocation s_uNormalMatrix("u_normalMatrix");
+static UniformLocation s_uTileZoom("u_tile_zoom");
+
+void DrawList::addTiles(const std::vector<MapTile*>& _tiles, bool _proxy, const Scene& _scene, const View& _view) {
+
+    const auto& styles = _scene.getStyles();
+
+    for (MapTile* tile : _tiles) {
+
+        size_t transform = m_transforms.size();
+        bool hasMeshes = false;
+
+        for (size_t i = 0; i < styles.size(); i++) {
+
+            VboMesh* mesh = tile->getMesh(*styles[i]);
+
+            if (mesh) {
+                m_entries.push_back({ i, _proxy, mesh->getVertexBuffer(), mesh, transform });
+                hasMeshes = true;
+            }
+        }
+
+        if (hasMeshes) {
+            const glm::mat4& model = tile->getModelMatrix();
+            float zoom = tile->getID().z;
+
+            // Set the tile zoom level, using the sign to indicate whether the tile is a proxy
+            m_transforms.push_back({ _view.getViewMatrix() * model, _view.getViewProjectionMatrix() * model, _proxy ? -zoom : zoom });
+        }
+    }
+
+}
+
+void DrawList::build(const std::vector<MapTile*>& _tiles, const std::vector<MapTile*>& _proxyTiles, const Scene& _scene, const View& _view) {
+
+    m_transforms.clear();
+    m_entries.clear();
+
+    addTiles(_tiles, false, _scene, _view);
+    addTiles(_proxyTiles, true, _scene, _view);
+
+    std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry& _a, const Entry& _b) {
+        if (_a.style != _b.style) { return _a.style < _b.style; }
+        if (_a.proxy != _b.proxy) { return _b.proxy; }
+        return _a.buffer < _b.buffer;
+    });
+
+}
+
+void DrawList::draw(const std::shared_ptr<Scene>& _scene, const std::shared_ptr<View>& _view, bool _maskProxies) {
+
+    const auto& styles = _scene->getStyles();
+    auto entry = m_entries.begin();
+
+    for (size_t i = 0; i < styles.size(); i++) {
+
+        const auto& style = styles[i];
+        style->onBeginDrawFrame(_view, _scene);
+
+        std::shared_ptr<ShaderProgram> shader = style->getShaderProgram();
+        shader->setUniformMatrix3f(s_uNormalMatrix, glm::value_ptr(_view->getNormalMatrix()));
+
+        bool proxies = false;
+
+        for (; entry != m_entries.end() && entry->style == i; ++entry) {
+
+            if (_maskProxies && entry->proxy != proxies) {
+                ProxyMask::beginProxyTiles();
+                proxies = true;
+            }
+
+            const TileTransform& transform = m_transforms[entry->transform];
+
+            shader->setUniformMatrix4f(s_uModelView, glm::value_ptr(transform.modelView));
+            shader->setUniformMatrix4f(s_uModelViewProj, glm::value_ptr(transform.modelViewProj));
+            shader->setUniformf(s_uTileZoom, transform.tileZoom);
+
+            entry->mesh->draw(shader);
+        }
+
+        if (proxies) {
+            ProxyMask::beginLoadedTiles();
+        }
+
+        style->onEndDrawFrame();
+    }
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "glm/mat4x4.hpp"
+
+class MapTile;
+class Scene;
+class Style;
+class VboMesh;
+class View;
+
+/* List of the meshes drawn in a frame
+ *
+ * Built once per frame from the tiles to draw: the matrices of each tile are computed once for all of its
+ * meshes, and the entries are sorted by style (so that each style's program and lights are set up once),
+ * then by whether the tile is a proxy (so that the stencil state changes at most twice per style) and then
+ * by vertex buffer (so that meshes sub-allocated from the same buffer are drawn together)
+ */
+class DrawList {
+
+public:
+
+    /* Rebuilds the list for the meshes of _tiles and _proxyTiles in all styles of _scene, as seen from _view */
+    void build(const std::vector<MapTile*>& _tiles, const std::vector<MapTile*>& _proxyTiles, const Scene& _scene, const View& _view);
+
+    /*
+     * Draws the list, calling the begin and end callbacks of each style of _scene around its meshes;
+     * if _maskProxies is true the stencil test is switched to the proxy mask before proxy tiles
+     */
+    void draw(const std::shared_ptr<Scene>& _scene, const std::shared_ptr<View>& _view, bool _maskProxies);
+
+    size_t size() const { return m_entries.size(); }
+
+private:
+
+    /* Transformations of one tile, shared by all of its entries */
+    struct TileTransform {
+        glm::mat4 modelView;
+        glm::mat4 modelViewProj;
+        float tileZoom; // Zoom of the tile, negative for proxy tiles
+    };
+
+    struct Entry {
+        size_t style; // Index of the style in the scene
+        bool proxy;
+        unsigned int buffer; // Vertex buffer of the mesh at the time of building, 0 if not yet uploaded
+        VboMesh* mesh;
+        size_t transform; // Index into <m_transforms>
+    };
+
+    void addTiles(const std::vector<MapTile*>& _tiles, bool _proxy, const Scene& _scene, const View& _view);
+
+    std::vector<TileTransform> m_transforms;
+    std::vector<Entry> m_entries;
+
+};
@@ -15,7 +15,7 @@ int Labels::LODDiscardFunc(float _maxZoom, float _zoom) {
     return (int) MIN(floor(((log(-_zoom + (_maxZoom + 2)) / log(_maxZoom + 2) * (_maxZoom )) * 0.5)), MAX_LOD);
 }
 
-bool Labels::addLabel(MapTile& _tile, const std::string& _styleName, Label::Transform _transform, std::string _text, Label::Type _type) {
+bool Labels::addLabel(MapTile& _tile, size_t _styleID, Label::Transform _transform, std::string _text, Label::Type _type) {
     auto currentBuffer = m_ftContext->getCurrentBuffer();
 
     if ( (m_currentZoom - _tile.getID().z) > LODDiscardFunc(View::s_maxZoom, m_currentZoom)) {
@@ -33,12 +33,12 @@ bool Labels::addLabel(MapTile& _tile, const std::string& _styleName, Label::Tran
 
         l->update(m_view->getViewProjectionMatrix() * _tile.getModelMatrix(), m_screenSize, 0);
         std::unique_ptr<TileID> tileID(new TileID(_tile.getID()));
-        _tile.addLabel(_styleName, l);
+        _tile.addLabel(_styleID, l);
 
         // lock concurrent collection
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            m_pendingLabelUnits.emplace_back(LabelUnit(l, tileID, _styleName));
+            m_pendingLabelUnits.emplace_back(LabelUnit(l, tileID, _styleID));
         }
 
         return true;
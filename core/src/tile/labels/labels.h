@@ -20,16 +20,16 @@ private:
 
 public:
     std::unique_ptr<TileID> m_tileID;
-    std::string m_styleName;
+    size_t m_styleID;
 
-    LabelUnit(std::shared_ptr<Label>& _label, std::unique_ptr<TileID>& _tileID, const std::string& _styleName) : m_label(std::move(_label)), m_tileID(std::move(_tileID)), m_styleName(_styleName) {}
+    LabelUnit(std::shared_ptr<Label>& _label, std::unique_ptr<TileID>& _tileID, size_t _styleID) : m_label(std::move(_label)), m_tileID(std::move(_tileID)), m_styleID(_styleID) {}
 
-    LabelUnit(LabelUnit&& _other) : m_label(std::move(_other.m_label)), m_tileID(std::move(_other.m_tileID)), m_styleName(_other.m_styleName) {}
+    LabelUnit(LabelUnit&& _other) : m_label(std::move(_other.m_label)), m_tileID(std::move(_other.m_tileID)), m_styleID(_other.m_styleID) {}
 
     LabelUnit& operator=(LabelUnit&& _other) {
         m_label = std::move(_other.m_label);
         m_tileID = std::move(_other.m_tileID);
-        m_styleName = std::move(_other.m_styleName);
+        m_styleID = _other.m_styleID;
         return *this;
     }
 
@@ -57,7 +57,7 @@ public:
      * Creates a label for and associate it with the current processed <MapTile> TileID for a specific syle name
      * Returns true if label was created
      */
-    bool addLabel(MapTile& _tile, const std::string& _styleName, Label::Transform _transform, std::string _text, Label::Type _type);
+    bool addLabel(MapTile& _tile, size_t _styleID, Label::Transform _transform, std::string _text, Label::Type _type);
 
     void setFontContext(std::shared_ptr<FontContext> _ftContext) { m_ftContext = _ftContext; }
 
@@ -3,12 +3,25 @@
 #include "view/view.h"
 #include "util/tileID.h"
 #include "util/vboMesh.h"
+#include "util/shaderProgram.h"
 #include "text/fontContext.h"
 #include "labels/labels.h"
 
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
+#include <algorithm>
+#include <cmath>
+
+// Returns the element of the per-style vector _resources for the style ID _id, growing the vector if needed
+template <class T>
+static T& styleResource(std::vector<T>& _resources, size_t _id) {
+    if (_id >= _resources.size()) {
+        _resources.resize(_id + 1);
+    }
+    return _resources[_id];
+}
+
 MapTile::MapTile(TileID _id, const MapProjection& _projection) : m_id(_id),  m_projection(&_projection) {
 
     glm::dvec4 bounds = _projection.TileBounds(_id); // [x: xmin, y: ymin, z: xmax, w: ymax]
@@ -29,8 +42,9 @@ MapTile::MapTile(TileID _id, const MapProjection& _projection) : m_id(_id),  m_p
 MapTile::MapTile(MapTile&& _other) : m_id(std::move(m_id)), m_proxyCounter(std::move(_other.m_proxyCounter)), 
                                      m_projection(std::move(_other.m_projection)), m_scale(std::move(_other.m_scale)), 
                                      m_inverseScale(std::move(_other.m_inverseScale)), m_tileOrigin(std::move(_other.m_tileOrigin)), 
-                                     m_modelMatrix(std::move(_other.m_modelMatrix)), m_geometry(std::move(_other.m_geometry)), 
-                                     m_buffers(std::move(_other.m_buffers)) {}
+                                     m_modelMatrix(std::move(_other.m_modelMatrix)), m_boundsMin(_other.m_boundsMin),
+                                     m_boundsMax(_other.m_boundsMax), m_boundsPadding(_other.m_boundsPadding), m_geometry(std::move(_other.m_geometry)), 
+                                     m_labels(std::move(_other.m_labels)), m_buffers(std::move(_other.m_buffers)) {}
 
 
 MapTile::~MapTile() {
@@ -39,20 +53,66 @@ MapTile::~MapTile() {
 
 void MapTile::addGeometry(const Style& _style, std::shared_ptr<VboMesh> _mesh) {
 
-    m_geometry[_style.getName()] = std::move(_mesh); // Move-construct a unique_ptr at the value associated with the given style
+    styleResource(m_geometry, _style.getID()) = std::move(_mesh);
+
+}
+
+void MapTile::extendBounds(const glm::vec3& _min, const glm::vec3& _max, float _padding) {
+
+    m_boundsMin = glm::min(m_boundsMin, _min);
+    m_boundsMax = glm::max(m_boundsMax, _max);
+    m_boundsPadding = std::max(m_boundsPadding, _padding);
+
+}
+
+bool MapTile::isInFrustum(const View& _view) const {
+
+    glm::mat4 mvp = _view.getViewProjectionMatrix() * m_modelMatrix;
+
+    // Count the corners of the box outside of each clipping plane in clip space: the box is outside of
+    // the frustum if all of them are outside of one plane. The far plane is not tested, since the
+    // depth of proxy tiles is rescaled in their shaders
+    int outside[5] = { 0, 0, 0, 0, 0 };
+
+    // Line extrusions scale with 2^(tile zoom - view zoom) in polyline.vs, so they grow on child proxy tiles
+    // drawn below their zoom; they never shrink below their width at the tile's zoom for culling
+    float padding = m_boundsPadding * std::max(1.f, std::exp2(m_id.z - _view.getZoom()));
+    glm::vec3 boundsMin = m_boundsMin - glm::vec3(padding, padding, 0.f);
+    glm::vec3 boundsMax = m_boundsMax + glm::vec3(padding, padding, 0.f);
+
+    for (int i = 0; i < 8; i++) {
+        glm::vec4 corner(i & 1 ? boundsMax.x : boundsMin.x,
+                         i & 2 ? boundsMax.y : boundsMin.y,
+                         i & 4 ? boundsMax.z : boundsMin.z, 1.f);
+        glm::vec4 clip = mvp * corner;
+
+        if (clip.x < -clip.w) { outside[0]++; }
+        if (clip.x > clip.w) { outside[1]++; }
+        if (clip.y < -clip.w) { outside[2]++; }
+        if (clip.y > clip.w) { outside[3]++; }
+        if (clip.z < -clip.w) { outside[4]++; }
+    }
+
+    for (int count : outside) {
+        if (count == 8) {
+            return false;
+        }
+    }
+
+    return true;
 
 }
 
 void MapTile::setTextBuffer(const Style& _style, std::shared_ptr<TextBuffer> _buffer) {
 
-    m_buffers[_style.getName()] = _buffer;
+    styleResource(m_buffers, _style.getID()) = _buffer;
 }
 
 std::shared_ptr<TextBuffer> MapTile::getTextBuffer(const Style& _style) const {
-    auto it = m_buffers.find(_style.getName());
+    size_t id = _style.getID();
 
-    if (it != m_buffers.end()) {
-        return it->second;
+    if (id < m_buffers.size()) {
+        return m_buffers[id];
     }
 
     return nullptr;
@@ -71,28 +131,33 @@ void MapTile::update(float _dt, const View& _view) {
 void MapTile::updateLabels(float _dt, const Style& _style, const View& _view) {
     glm::mat4 mvp = _view.getViewProjectionMatrix() * m_modelMatrix;
     glm::vec2 screenSize = glm::vec2(_view.getWidth(), _view.getHeight());
+    size_t id = _style.getID();
+
+    if (id >= m_labels.size()) {
+        return;
+    }
     
-    for(auto& label : m_labels[_style.getName()]) {
+    for(auto& label : m_labels[id]) {
         label->update(mvp, screenSize, _dt);
     }
 }
 
 void MapTile::pushLabelTransforms(const Style& _style, std::shared_ptr<Labels> _labels) {
-    auto it = m_buffers.find(_style.getName());
+    size_t id = _style.getID();
     
-    if (it == m_buffers.end()) {
+    if (id >= m_buffers.size() || !m_buffers[id]) {
         return;
     }
 
-    auto textBuffer = it->second;
+    auto textBuffer = m_buffers[id];
     
-    if (textBuffer->hasData()) {
+    if (textBuffer->hasData() && id < m_labels.size()) {
         auto ftContext = _labels->getFontContext();
 
         ftContext->lock();
         ftContext->useBuffer(textBuffer);
         
-        for(auto& label : m_labels[_style.getName()]) {
+        for(auto& label : m_labels[id]) {
             label->pushTransform(textBuffer);
         }
         
@@ -102,36 +167,33 @@ void MapTile::pushLabelTransforms(const Style& _style, std::shared_ptr<Labels> _
     
 }
 
-void MapTile::draw(const Style& _style, const View& _view) {
-
-    const std::shared_ptr<VboMesh>& styleMesh = m_geometry[_style.getName()];
-    
-    if (styleMesh) {
-        
-        std::shared_ptr<ShaderProgram> shader = _style.getShaderProgram();
-
-        glm::mat4 modelViewMatrix = _view.getViewMatrix() * m_modelMatrix;
-        glm::mat4 modelViewProjMatrix = _view.getViewProjectionMatrix() * m_modelMatrix;
-        
-        shader->setUniformMatrix4f("u_modelView", glm::value_ptr(modelViewMatrix));
-        shader->setUniformMatrix4f("u_modelViewProj", glm::value_ptr(modelViewProjMatrix));
-        shader->setUniformMatrix3f("u_normalMatrix", glm::value_ptr(_view.getNormalMatrix()));
-
-        // Set the tile zoom level, using the sign to indicate whether the tile is a proxy
-        shader->setUniformf("u_tile_zoom", m_proxyCounter > 0 ? -m_id.z : m_id.z);
-
-        styleMesh->draw(shader);
+bool MapTile::hasGeometry() {
+    for (const auto& geometry : m_geometry) {
+        if (geometry) {
+            return true;
+        }
     }
+    return false;
 }
 
-bool MapTile::hasGeometry() {
-    return (m_geometry.size() != 0);
+std::shared_ptr<VboMesh>& MapTile::getGeometry(const Style& _style) {
+    return m_geometry.at(_style.getID());
 }
 
-std::shared_ptr<VboMesh>& MapTile::getGeometry(const Style& _style) {
-    return m_geometry.at(_style.getName());
+VboMesh* MapTile::getMesh(const Style& _style) const {
+    size_t id = _style.getID();
+    return id < m_geometry.size() ? m_geometry[id].get() : nullptr;
+}
+
+bool MapTile::needsRebuild() const {
+    for (const auto& geometry : m_geometry) {
+        if (geometry && geometry->needsRebuild()) {
+            return true;
+        }
+    }
+    return false;
 }
 
-void MapTile::addLabel(const std::string& _styleName, std::shared_ptr<Label> _label) {
-    m_labels[_styleName].push_back(std::move(_label));
+void MapTile::addLabel(size_t _styleID, std::shared_ptr<Label> _label) {
+    styleResource(m_labels, _styleID).push_back(std::move(_label));
 }
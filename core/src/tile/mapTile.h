@@ -1,13 +1,11 @@
 #pragma once
 
-#include <map>
 #include <memory>
-#include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "glm/mat4x4.hpp"
 #include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
 
 #include "tileID.h"
 
@@ -51,6 +49,24 @@ public:
     
     const glm::mat4& getModelMatrix() const { return m_modelMatrix; }
 
+    /*
+     * Extends the bounding box of this tile's geometry to contain the box [_min, _max], in tile units; meshes
+     * may reach _padding beyond it in x and y at the zoom of the tile (see <Style::boundsPadding()>)
+     */
+    void extendBounds(const glm::vec3& _min, const glm::vec3& _max, float _padding = 0.f);
+
+    /* Returns the corners of the bounding box of this tile's geometry in tile units; the box contains at
+     * least the area of the tile at height 0, and the full height of extruded features */
+    const glm::vec3& getBoundsMin() const { return m_boundsMin; }
+    const glm::vec3& getBoundsMax() const { return m_boundsMax; }
+    float getBoundsPadding() const { return m_boundsPadding; }
+
+    /*
+     * Returns false if the bounding box of this tile is entirely outside of the view frustum of _view,
+     * as seen through the model matrix of the last <update()>; the box is padded for the zoom of _view
+     */
+    bool isInFrustum(const View& _view) const;
+
     /* Adds drawable geometry to the tile and associates it with a <Style>
      * 
      * Use std::move to pass in the mesh by move semantics; Geometry in the mesh
@@ -58,7 +74,8 @@ public:
      */
     void addGeometry(const Style& _style, std::shared_ptr<VboMesh> _mesh);
     
-    void addLabel(const std::string& _styleName, std::shared_ptr<Label> _label);
+    /* Adds a label of the style with ID _styleID to the tile */
+    void addLabel(size_t _styleID, std::shared_ptr<Label> _label);
     
     /*
      * Method to check if this tile's vboMesh(s) are loaded and ready to be drawn
@@ -67,6 +84,17 @@ public:
     
     std::shared_ptr<VboMesh>& getGeometry(const Style& _style);
 
+    /* Returns the mesh associated with _style, or nullptr if the tile has no geometry in _style */
+    VboMesh* getMesh(const Style& _style) const;
+
+    /* Returns the meshes of this tile indexed by style ID; styles without geometry have a nullptr */
+    const std::vector<std::shared_ptr<VboMesh>>& getMeshes() const { return m_geometry; }
+
+    /*
+     * Returns true if any of this tile's meshes lost its GL buffers and has no data left to restore them
+     */
+    bool needsRebuild() const;
+
     /* uUdate the Tile considering the current view */
     void update(float _dt, const View& _view);
 
@@ -79,9 +107,6 @@ public:
     void setTextBuffer(const Style& _style, std::shared_ptr<TextBuffer> _buffer);
     std::shared_ptr<TextBuffer> getTextBuffer(const Style& _style) const;
 
-    /* Draws the geometry associated with the provided <Style> and view-projection matrix */
-    void draw(const Style& _style, const View& _view);
-    
     /* 
      * methods to set and get proxy counter
      */
@@ -112,8 +137,13 @@ private:
     // Distances from the global origin are too large to represent precisely in 32-bit floats, so we only apply the
     // relative translation from the view origin to the model origin immediately before drawing the tile. 
 
-    std::unordered_map<std::string, std::shared_ptr<VboMesh>> m_geometry; // Map of <Style>s and their associated <VboMesh>es
-    std::unordered_map<std::string, std::vector<std::shared_ptr<Label>>> m_labels;
-    std::map<std::string, std::shared_ptr<TextBuffer>> m_buffers; // Map of <Style>s and the associated text buffer
+    glm::vec3 m_boundsMin = glm::vec3(-1.f, -1.f, 0.f); // Bounding box of the geometry of the tile, in tile units
+    glm::vec3 m_boundsMax = glm::vec3(1.f, 1.f, 0.f);
+    float m_boundsPadding = 0.f; // Reach of the meshes beyond the bounding box in x and y at the zoom of the tile
+
+    // Per-style resources, indexed by style ID (see <Style::getID()>); sized to the highest ID used by the tile
+    std::vector<std::shared_ptr<VboMesh>> m_geometry; // <VboMesh> of each <Style>, or nullptr
+    std::vector<std::vector<std::shared_ptr<Label>>> m_labels; // Labels of each <Style>
+    std::vector<std::shared_ptr<TextBuffer>> m_buffers; // Text buffer of each <Style>, or nullptr
 
 };
@@ -0,0 +1,119 @@
+#include "proxyMask.h"
+
+#include "gl.h"
+#include "platform.h"
+#include "tile/mapTile.h"
+#include "util/shaderProgram.h"
+#include "util/typedMesh.h"
+#include "util/vertexLayout.h"
+#include "view/view.h"
+
+#include "glm/gtc/type_ptr.hpp"
+
+namespace ProxyMask {
+
+    static bool s_available = false;
+    static std::shared_ptr<ShaderProgram> s_shader;
+    static std::unique_ptr<TypedMesh<glm::vec2>> s_mesh;
+
+    static const GLchar* s_vert = R"END(
+    #ifdef GL_ES
+    precision highp float;
+    #endif
+
+    attribute vec2 a_position;
+
+    uniform mat4 u_modelViewProj;
+
+    void main() {
+        gl_Position = u_modelViewProj * vec4(a_position, 0.0, 1.0);
+    }
+
+    )END";
+
+    static const GLchar* s_frag = R"END(
+    #ifdef GL_ES
+    precision mediump float;
+    #endif
+
+    void main() {
+        gl_FragColor = vec4(1.0);
+    }
+
+    )END";
+
+    void init() {
+
+        GLint stencilBits = 0;
+        glGetIntegerv(GL_STENCIL_BITS, &stencilBits);
+        s_available = stencilBits > 0;
+
+        if (!s_available) {
+            logMsg("WARNING: No stencil buffer, proxy tiles are drawn unmasked\n");
+            return;
+        }
+
+        if (!s_shader) {
+            s_shader = std::make_shared<ShaderProgram>();
+            s_shader->setSourceStrings(s_frag, s_vert);
+
+            auto layout = std::shared_ptr<VertexLayout>(new VertexLayout({
+                {"a_position", 2, GL_FLOAT, false, 0},
+            }));
+
+            // Square of a tile in tile units
+            s_mesh = std::unique_ptr<TypedMesh<glm::vec2>>(new TypedMesh<glm::vec2>(layout, GL_TRIANGLES));
+            s_mesh->addVertices({ {-1.f, -1.f}, {1.f, -1.f}, {1.f, 1.f}, {-1.f, 1.f} }, { 0, 1, 2, 0, 2, 3 });
+            s_mesh->compileVertexBuffer();
+        }
+
+    }
+
+    bool isAvailable() {
+        return s_available;
+    }
+
+    void write(const std::vector<MapTile*>& _tiles, const View& _view) {
+
+        static UniformLocation s_uModelViewProj("u_modelViewProj");
+
+        glEnable(GL_STENCIL_TEST);
+        glStencilFunc(GL_ALWAYS, 1, 0xFF);
+        glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+        // Only the stencil buffer is written, over the whole footprint regardless of depth
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        glDisable(GL_DEPTH_TEST);
+        glDisable(GL_CULL_FACE);
+
+        for (const MapTile* tile : _tiles) {
+            glm::mat4 modelViewProj = _view.getViewProjectionMatrix() * tile->getModelMatrix();
+            s_shader->setUniformMatrix4f(s_uModelViewProj, glm::value_ptr(modelViewProj));
+            s_mesh->draw(s_shader);
+        }
+
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        glDepthMask(GL_TRUE);
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_CULL_FACE);
+
+        beginLoadedTiles();
+
+    }
+
+    void beginLoadedTiles() {
+        glStencilFunc(GL_ALWAYS, 0, 0xFF);
+        glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    }
+
+    void beginProxyTiles() {
+        glStencilFunc(GL_EQUAL, 0, 0xFF);
+        glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    }
+
+    void end() {
+        glDisable(GL_STENCIL_TEST);
+    }
+
+}
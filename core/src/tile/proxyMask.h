@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+class MapTile;
+class View;
+
+/* Stencil masking of proxy tiles
+ *
+ * While a tile loads, its parent or children are drawn in its place as proxies; without masking, proxies
+ * are drawn in full under the loaded tiles around them. Writing the footprints of the loaded tiles into
+ * the stencil buffer first lets proxies be drawn only where no loaded tile covers the screen.
+ */
+namespace ProxyMask {
+
+    /*
+     * Checks whether the framebuffer has a stencil buffer; must be called on the GL thread after the
+     * context is created, masking is skipped without one
+     */
+    void init();
+
+    /* Returns true if proxy tiles can be masked */
+    bool isAvailable();
+
+    /*
+     * Sets the stencil buffer to 1 within the footprints (the tile square at height 0) of _tiles and
+     * enables the stencil test with <beginLoadedTiles()> state; the stencil buffer must be cleared to 0
+     */
+    void write(const std::vector<MapTile*>& _tiles, const View& _view);
+
+    /* Sets the stencil test to pass everywhere, for drawing loaded tiles */
+    void beginLoadedTiles();
+
+    /* Sets the stencil test to pass only outside of the written footprints, for drawing proxy tiles */
+    void beginProxyTiles();
+
+    /* Disables the stencil test */
+    void end();
+
+}
@@ -18,7 +18,8 @@ TileManager::TileManager(TileManager&& _other) :
     m_tileSet(std::move(_other.m_tileSet)),
     m_dataSources(std::move(_other.m_dataSources)),
     m_workers(std::move(_other.m_workers)),
-    m_queuedTiles(std::move(_other.m_queuedTiles)) {
+    m_queuedTiles(std::move(_other.m_queuedTiles)),
+    m_uploadQueue(std::move(_other.m_uploadQueue)) {
 }
 
 TileManager::~TileManager() {
@@ -32,6 +33,7 @@ TileManager::~TileManager() {
         // which could delay closing of the application. 
     }
     m_dataSources.clear();
+    m_uploadQueue.clear();
     m_tileSet.clear();
 }
 
@@ -63,7 +65,7 @@ void TileManager::updateTileSet() {
             auto& worker = *workersIter;
 
             if (worker->isFree()) {
-                worker->processTileData(std::move(*queuedTilesIter), m_scene->getStyles(), *m_view);
+                worker->processTileData(std::move(*queuedTilesIter), *m_scene, *m_view);
                 queuedTilesIter = m_queuedTiles.erase(queuedTilesIter);
             }
 
@@ -76,16 +78,32 @@ void TileManager::updateTileSet() {
         
         if (!worker->isFree() && worker->isFinished()) {
             
-            // Get result from worker and move it into tile set
+            // Get result from worker and queue it for upload
             auto tile = worker->getTileResult();
             const TileID& id = tile->getID();
             logMsg("Tile [%d, %d, %d] finished loading\n", id.z, id.x, id.y);
+            m_uploadQueue.push(std::move(tile));
+            
+        }
+        
+    }
+
+    // Upload finished tiles within the frame budget and move the uploaded ones into tile set
+    {
+        std::vector<std::shared_ptr<MapTile>> uploadedTiles;
+        std::vector<TileID> lostTiles;
+        m_uploadQueue.process(*m_view, uploadedTiles, lostTiles);
+
+        for (auto& tile : uploadedTiles) {
+            const TileID& id = tile->getID();
             std::swap(m_tileSet[id], tile);
             cleanProxyTiles(id);
             m_tileSetChanged = true;
-            
         }
-        
+
+        for (const auto& id : lostTiles) {
+            loadTileData(id);
+        }
     }
     
     if (! (m_view->changedOnLastUpdate() || m_tileSetChanged) ) {
@@ -146,19 +164,33 @@ void TileManager::updateTileSet() {
     }
 }
 
-void TileManager::addTile(const TileID& _tileID) {
-    
-    std::shared_ptr<MapTile> tile(new MapTile(_tileID, m_view->getMapProjection()));
-    m_tileSet[_tileID] = std::move(tile);
+void TileManager::rebuildLostTiles() {
+
+    for (auto& entry : m_tileSet) {
+
+        if (!entry.second->needsRebuild()) {
+            continue;
+        }
+
+        loadTileData(entry.first);
+    }
+}
+
+void TileManager::loadTileData(const TileID& _tileID) {
 
     for (auto& source : m_dataSources) {
-        
         if (!source->loadTileData(_tileID, *this)) {
-            
             logMsg("ERROR: Loading failed for tile [%d, %d, %d]\n", _tileID.z, _tileID.x, _tileID.y);
-            
         }
     }
+}
+
+void TileManager::addTile(const TileID& _tileID) {
+    
+    std::shared_ptr<MapTile> tile(new MapTile(_tileID, m_view->getMapProjection()));
+    m_tileSet[_tileID] = std::move(tile);
+
+    loadTileData(_tileID);
     
     //Add Proxy if corresponding proxy MapTile ready
     updateProxyTiles(_tileID);
@@ -185,6 +217,9 @@ void TileManager::removeTile(std::map< TileID, std::shared_ptr<MapTile> >::itera
         cleanProxyTiles(id);
     }
     
+    // Drop the tile if it is waiting for upload
+    m_uploadQueue.remove(id);
+
     // If a worker is processing this tile, abort it
     for (const auto& worker : m_workers) {
         if (!worker->isFree() && worker->getTileID() == id) {
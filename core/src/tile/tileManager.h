@@ -9,6 +9,7 @@
 #include <mutex>
 
 #include "tileWorker.h"
+#include "uploadQueue.h"
 #include "util/tileID.h"
 #include "data/dataSource.h"
 
@@ -55,10 +56,24 @@ public:
 
     void addToWorkerQueue(std::shared_ptr<TileData>& _parsedData, const TileID& _id, DataSource* _source);
     
+    /* Queues the tiles whose geometry was lost with the GL context to be built again
+     *
+     * Data sources serve cached <TileData> for these tiles where they have it; the tiles keep
+     * their place in the tile set until the rebuilt ones replace them. Tiles still waiting in the
+     * upload queue are built again once the queue finds them incomplete
+     */
+    void rebuildLostTiles();
+
     /* Returns the set of currently visible tiles */
     const std::map<TileID, std::shared_ptr<MapTile>>& getVisibleTiles() { return m_tileSet; }
     
     bool hasTileSetChanged() { return m_tileSetChanged; }
+
+    /* Returns true if finished tiles are waiting for their meshes to be uploaded */
+    bool hasPendingUploads() const { return !m_uploadQueue.empty(); }
+
+    /* Sets the bytes and milliseconds spent uploading finished tiles per update, 0 for no limit (see <UploadQueue>) */
+    void setUploadBudget(size_t _bytes, float _milliseconds) { m_uploadQueue.setBudget(_bytes, _milliseconds); }
     
 private:
 
@@ -78,6 +93,9 @@ private:
     std::list<std::unique_ptr<TileWorker> > m_workers;
     
     std::list<std::unique_ptr<TileTask> > m_queuedTiles;
+
+    // Finished tiles, which replace their placeholders in m_tileSet once their meshes are uploaded
+    UploadQueue m_uploadQueue;
     
     bool m_tileSetChanged = false;
     
@@ -87,6 +105,9 @@ private:
      * @_tileID: TileID for which new MapTile needs to be constructed
      */
     void addTile(const TileID& _tileID);
+
+    /* Requests the data of _tileID from every data source */
+    void loadTileData(const TileID& _tileID);
     
     /*
      * Removes a tile from m_tileSet
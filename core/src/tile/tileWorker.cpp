@@ -2,6 +2,7 @@
 #include "platform.h"
 #include "view/view.h"
 #include "style/style.h"
+#include "scene/scene.h"
 
 #include <chrono>
 
@@ -16,7 +17,7 @@ void TileWorker::abort() {
 }
 
 void TileWorker::processTileData(std::unique_ptr<TileTask> _task,
-                                 const std::vector<std::unique_ptr<Style>>& _styles,
+                                 const Scene& _scene,
                                  const View& _view) {
 
     m_task = std::move(_task);
@@ -40,20 +41,51 @@ void TileWorker::processTileData(std::unique_ptr<TileTask> _task,
             // Data needs to be parsed
             tileData = dataSource->parse(*tile, m_task->rawTileData);
 
+            // Clip and simplify geometry, if enabled for this source
+            dataSource->processTileData(*tileData);
+
             // Cache parsed data with the original data source
             dataSource->setTileData(tileID, tileData);
         }
         
 		tile->update(0, _view);
 
+        const auto& styles = _scene.getStyles();
+
+        // Route features to the styles that draw them in a single pass over the tile data
+        std::vector<std::vector<StyledFeature>> styledFeatures(styles.size());
+
+        if (tileData) {
+
+            // Context values available to filters; the tile zoom is also exposed as 'zoom' for filters written against it
+            Tangram::NumValue zoom(tileID.z);
+            Tangram::Context ctx = { { "$zoom", &zoom }, { "zoom", &zoom } };
+
+            for (auto& layer : tileData->layers) {
+
+                // Skip any layers that no style has a rule for
+                const auto* rules = _scene.getLayerRules(layer.name);
+                if (!rules) { continue; }
+
+                for (auto& feature : layer.features) {
+                    for (const auto& rule : *rules) {
+                        // Discard features rejected by a rule's filter before doing any geometry work
+                        if (styles[rule.style]->getLayers()[rule.rule].filter.eval(feature, ctx)) {
+                            styledFeatures[rule.style].push_back({ &feature, rule.rule });
+                        }
+                    }
+                }
+            }
+        }
+
         //Process data for all styles
-        for(const auto& style : _styles) {
+        for (size_t i = 0; i < styles.size(); i++) {
             if(m_aborted) {
                 m_finished = true;
                 return std::move(tile);
             }
             if(tileData) {
-                style->addData(*tileData, *tile, _view.getMapProjection());
+                styles[i]->addData(styledFeatures[i], *tile, _view.getMapProjection());
             }
         }
         m_finished = true;
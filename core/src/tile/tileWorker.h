@@ -7,6 +7,8 @@
 #include "data/dataSource.h"
 #include "mapTile.h"
 
+class Scene;
+
 struct TileTask {
 
     TileID tileID;
@@ -50,7 +52,7 @@ public:
     TileWorker();
     
     void processTileData(std::unique_ptr<TileTask> _task,
-                         const std::vector<std::unique_ptr<Style>>& _styles,
+                         const Scene& _scene,
                          const View& _view);
     
     void abort();
@@ -0,0 +1,102 @@
+#include "uploadQueue.h"
+
+#include "tile/mapTile.h"
+#include "util/vboMesh.h"
+#include "view/view.h"
+
+#include "glm/geometric.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+void UploadQueue::setBudget(size_t _bytes, float _milliseconds) {
+
+    m_budgetBytes = _bytes;
+    m_budgetMilliseconds = _milliseconds;
+
+}
+
+void UploadQueue::push(std::shared_ptr<MapTile> _tile) {
+
+    m_tiles.push_back({ std::move(_tile), 0, 0.f, 0.0 });
+
+}
+
+void UploadQueue::remove(const TileID& _id) {
+
+    m_tiles.erase(std::remove_if(m_tiles.begin(), m_tiles.end(), [&](const Entry& _entry) {
+        return _entry.tile->getID() == _id;
+    }), m_tiles.end());
+
+}
+
+void UploadQueue::process(const View& _view, std::vector<std::shared_ptr<MapTile>>& _uploaded, std::vector<TileID>& _lost) {
+
+    if (m_tiles.empty()) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Update the priorities for the current view; distances are in units of the tile size
+    const glm::dvec3& viewPosition = _view.getPosition();
+    float viewZoom = std::floor(_view.getZoom());
+
+    for (auto& entry : m_tiles) {
+        const MapTile& tile = *entry.tile;
+        entry.zoomDelta = std::abs(tile.getID().z - viewZoom);
+        entry.distance = glm::length(tile.getOrigin() - glm::dvec2(viewPosition)) * tile.getInverseScale();
+    }
+
+    std::stable_sort(m_tiles.begin(), m_tiles.end(), [](const Entry& _a, const Entry& _b) {
+        if (_a.zoomDelta != _b.zoomDelta) { return _a.zoomDelta < _b.zoomDelta; }
+        return _a.distance < _b.distance;
+    });
+
+    size_t bytes = 0;
+    bool uploaded = false;
+
+    auto withinBudget = [&]() {
+        if (!uploaded) {
+            return true;
+        }
+        if (m_budgetBytes > 0 && bytes >= m_budgetBytes) {
+            return false;
+        }
+        if (m_budgetMilliseconds > 0) {
+            std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed.count() < m_budgetMilliseconds;
+        }
+        return true;
+    };
+
+    auto it = m_tiles.begin();
+
+    while (it != m_tiles.end()) {
+
+        const auto& meshes = it->tile->getMeshes();
+
+        while (it->nextMesh < meshes.size() && withinBudget()) {
+            const auto& mesh = meshes[it->nextMesh++];
+            if (mesh) {
+                bytes += mesh->uploadIfNeeded();
+                uploaded = true;
+            }
+        }
+
+        if (it->nextMesh < meshes.size()) {
+            // Out of budget, the rest waits for the next frame
+            break;
+        }
+
+        if (it->tile->needsRebuild()) {
+            // The context was lost after some of its meshes were uploaded and their data released
+            _lost.push_back(it->tile->getID());
+        } else {
+            _uploaded.push_back(std::move(it->tile));
+        }
+        it = m_tiles.erase(it);
+    }
+
+}
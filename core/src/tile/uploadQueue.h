@@ -0,0 +1,59 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "util/tileID.h"
+
+class MapTile;
+class View;
+
+/* Queue of built tiles waiting for their meshes to be uploaded to the GPU
+ *
+ * Uploading the meshes of every tile finished in a frame at once stalls that frame; the queue uploads them
+ * in priority order (tiles at the zoom of the view first, then the tiles nearest to the view center) up
+ * to a budget of bytes and milliseconds per frame, and releases each tile once all of its meshes are
+ * uploaded. Must be processed on the GL thread.
+ */
+class UploadQueue {
+
+public:
+
+    /*
+     * Sets the budget of each <process()> call in bytes uploaded and milliseconds spent, 0 for no limit;
+     * at least one mesh is uploaded per call so that the queue always progresses
+     */
+    void setBudget(size_t _bytes, float _milliseconds);
+
+    /* Adds a built tile to the queue */
+    void push(std::shared_ptr<MapTile> _tile);
+
+    /* Removes the tiles with the given ID from the queue */
+    void remove(const TileID& _id);
+
+    /*
+     * Uploads queued meshes within the budget and appends the tiles which are fully uploaded to _uploaded;
+     * tiles which lost meshes uploaded before a loss of the GL context (see <MapTile::needsRebuild()>) are
+     * dropped instead and their IDs appended to _lost, to be built again
+     */
+    void process(const View& _view, std::vector<std::shared_ptr<MapTile>>& _uploaded, std::vector<TileID>& _lost);
+
+    bool empty() const { return m_tiles.empty(); }
+
+    void clear() { m_tiles.clear(); }
+
+private:
+
+    struct Entry {
+        std::shared_ptr<MapTile> tile;
+        size_t nextMesh; // Index of the next mesh of the tile to upload
+        float zoomDelta; // Sort keys, from the view of the last process() call
+        double distance;
+    };
+
+    std::vector<Entry> m_tiles;
+
+    size_t m_budgetBytes = 1 << 20;
+    float m_budgetMilliseconds = 4.f;
+
+};
@@ -0,0 +1,117 @@
+#include "bufferArena.h"
+#include "vboMesh.h"
+#include "platform.h"
+
+#include <algorithm>
+
+BufferArena::BufferArena(GLenum _target, GLsizeiptr _pageSize) : m_target(_target), m_pageSize(_pageSize) {
+    m_generation = VboMesh::getValidGeneration();
+}
+
+BufferArena::~BufferArena() {
+    checkValidity();
+
+    for (auto& page : m_pages) {
+        VboMesh::deleteBuffer(m_target, page.buffer);
+    }
+}
+
+void BufferArena::checkValidity() {
+    if (m_generation != VboMesh::getValidGeneration()) {
+        // Buffer objects of the lost context are gone with it
+        m_pages.clear();
+        m_generation = VboMesh::getValidGeneration();
+    }
+}
+
+BufferArena::Range BufferArena::allocate(GLsizeiptr _size, const GLvoid* _data) {
+
+    checkValidity();
+
+    Range range;
+    GLsizeiptr size = (_size + BUFFER_ARENA_ALIGNMENT - 1) & ~(GLsizeiptr)(BUFFER_ARENA_ALIGNMENT - 1);
+
+    // First fit over the free ranges of all pages
+    for (size_t i = 0; i < m_pages.size() && !range.valid(); i++) {
+        auto& freeRanges = m_pages[i].freeRanges;
+
+        for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+            if (it->second >= size) {
+                range.page = i;
+                range.offset = it->first;
+
+                GLsizeiptr remaining = it->second - size;
+                freeRanges.erase(it);
+                if (remaining > 0) {
+                    freeRanges[range.offset + size] = remaining;
+                }
+                break;
+            }
+        }
+    }
+
+    if (!range.valid()) {
+        Page page;
+        page.size = std::max(m_pageSize, size);
+
+        glGenBuffers(1, &page.buffer);
+        VboMesh::bindBuffer(m_target, page.buffer);
+        glBufferData(m_target, page.size, NULL, GL_STATIC_DRAW);
+
+        if (page.size > size) {
+            page.freeRanges[size] = page.size - size;
+        }
+
+        range.page = m_pages.size();
+        range.offset = 0;
+        m_pages.push_back(std::move(page));
+    }
+
+    range.size = size;
+    range.generation = m_generation;
+
+    VboMesh::bindBuffer(m_target, m_pages[range.page].buffer);
+    glBufferSubData(m_target, range.offset, _size, _data);
+
+    return range;
+}
+
+void BufferArena::release(Range& _range) {
+
+    // Ranges never allocated return before touching the arena state, so meshes which were not uploaded
+    // can be destroyed on any thread
+    if (!_range.valid()) {
+        return;
+    }
+
+    checkValidity();
+
+    if (_range.generation != m_generation) {
+        _range = Range();
+        return;
+    }
+
+    auto& freeRanges = m_pages[_range.page].freeRanges;
+
+    GLintptr offset = _range.offset;
+    GLsizeiptr size = _range.size;
+
+    // Merge with the following free range
+    auto next = freeRanges.find(offset + size);
+    if (next != freeRanges.end()) {
+        size += next->second;
+        freeRanges.erase(next);
+    }
+
+    // Merge with the preceding free range
+    auto inserted = freeRanges.emplace(offset, size).first;
+    if (inserted != freeRanges.begin()) {
+        auto prev = std::prev(inserted);
+        if (prev->first + prev->second == offset) {
+            prev->second += size;
+            freeRanges.erase(inserted);
+        }
+    }
+
+    _range = Range();
+}
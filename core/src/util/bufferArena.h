@@ -0,0 +1,70 @@
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "gl.h"
+
+#define BUFFER_ARENA_PAGE_SIZE (1 << 20) // Default size in bytes of the buffer objects an arena allocates from
+#define BUFFER_ARENA_ALIGNMENT 16
+
+/*
+ * BufferArena - Large OpenGL buffer objects shared by many meshes, which are sub-allocated as byte ranges
+ *
+ * Each page is one buffer object with a free-list of the byte ranges not in use; allocations take the first
+ * free range that fits (adding a page if none does) and released ranges are merged with their free neighbours.
+ * Meshes of the same kind (e.g. all tiles of one <Style>) sharing an arena are drawn from a few buffers, so
+ * consecutive draws seldom need to bind a different one. Must only be used on the GL thread.
+ */
+class BufferArena {
+
+public:
+
+    /* Byte range of an allocation within one page of the arena */
+    struct Range {
+        int page = -1;
+        GLintptr offset = 0;
+        GLsizeiptr size = 0;
+        int generation = -1; // GL context generation in which the range was allocated
+
+        bool valid() const { return page >= 0; }
+    };
+
+    /*
+     * Creates an arena of buffer objects bound to _target (GL_ARRAY_BUFFER or GL_ELEMENT_ARRAY_BUFFER);
+     * buffer objects are only created once ranges are allocated
+     */
+    BufferArena(GLenum _target, GLsizeiptr _pageSize = BUFFER_ARENA_PAGE_SIZE);
+
+    ~BufferArena();
+
+    /* Allocates a range of _size bytes and fills it with _data */
+    Range allocate(GLsizeiptr _size, const GLvoid* _data);
+
+    /*
+     * Returns _range to the free-list of its page; ranges of a lost GL context are ignored, and ranges never
+     * allocated are ignored without touching the arena (the only call safe off the GL thread)
+     */
+    void release(Range& _range);
+
+    /* Returns the buffer object holding _range */
+    GLuint getBuffer(const Range& _range) const { return m_pages[_range.page].buffer; }
+
+private:
+
+    struct Page {
+        GLuint buffer;
+        GLsizeiptr size;
+        std::map<GLintptr, GLsizeiptr> freeRanges; // Map of offsets to sizes of the unused ranges
+    };
+
+    /* Drops all pages if the GL context was lost since they were created */
+    void checkValidity();
+
+    GLenum m_target;
+    GLsizeiptr m_pageSize;
+
+    std::vector<Page> m_pages;
+    int m_generation;
+
+};
@@ -1,153 +1,411 @@
 #include "builders.h"
 
 #include "tesselator.h"
-#include "aabb.h"
 #include "geom.h"
-#include "glm/gtx/rotate_vector.hpp"
 
-#include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
-void* alloc(void* _userData, unsigned int _size) {
-    return malloc(_size);
+#define TESS_ARENA_BLOCK_SIZE 65536
+#define TESS_ARENA_ALIGN 16
+
+/* Bump allocator backing the libtess2 tesselator of a thread
+ *
+ * Frees are ignored; memory is reclaimed all at once by rewinding the arena
+ * between polygons, so a tile's worth of polygons needs no heap allocations
+ * once the blocks have grown to the size of its largest polygon
+ */
+class TessArena {
+
+public:
+
+    ~TessArena() {
+        for (auto& block : m_blocks) {
+            std::free(block.data);
+        }
+    }
+
+    void* alloc(size_t _size) {
+        // each allocation is preceded by an aligned header holding its size, for realloc
+        size_t size = (_size + 2 * TESS_ARENA_ALIGN - 1) & ~(size_t)(TESS_ARENA_ALIGN - 1);
+
+        while (m_current < m_blocks.size() && m_blocks[m_current].used + size > m_blocks[m_current].size) {
+            m_current++;
+        }
+        if (m_current == m_blocks.size()) {
+            size_t blockSize = std::max(size, (size_t)TESS_ARENA_BLOCK_SIZE);
+            m_blocks.push_back({ static_cast<char*>(std::malloc(blockSize)), blockSize, 0 });
+        }
+
+        Block& block = m_blocks[m_current];
+        char* ptr = block.data + block.used;
+        block.used += size;
+
+        *reinterpret_cast<size_t*>(ptr) = _size;
+        return ptr + TESS_ARENA_ALIGN;
+    }
+
+    void* realloc(void* _ptr, size_t _size) {
+        if (!_ptr) {
+            return alloc(_size);
+        }
+
+        size_t oldSize = *reinterpret_cast<size_t*>(static_cast<char*>(_ptr) - TESS_ARENA_ALIGN);
+        if (_size <= oldSize) {
+            return _ptr;
+        }
+
+        void* ptr = alloc(_size);
+        std::memcpy(ptr, _ptr, oldSize);
+        return ptr;
+    }
+
+    /* Marks the current position, see rewind() */
+    void mark() {
+        m_markBlock = m_current;
+        m_markUsed = m_current < m_blocks.size() ? m_blocks[m_current].used : 0;
+    }
+
+    /* Releases everything allocated since the last mark() */
+    void rewind() {
+        for (size_t i = m_markBlock; i < m_blocks.size(); i++) {
+            m_blocks[i].used = i == m_markBlock ? m_markUsed : 0;
+        }
+        m_current = m_markBlock;
+    }
+
+    /* Releases all allocations */
+    void reset() {
+        m_markBlock = m_markUsed = 0;
+        rewind();
+    }
+
+private:
+
+    struct Block {
+        char* data;
+        size_t size;
+        size_t used;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_current = 0;
+    size_t m_markBlock = 0;
+    size_t m_markUsed = 0;
+
+};
+
+static void* arenaAlloc(void* _userData, unsigned int _size) {
+    return static_cast<TessArena*>(_userData)->alloc(_size);
 }
 
-void* realloc(void* _userData, void* _ptr, unsigned int _size) {
-    return realloc(_ptr, _size);
+static void* arenaRealloc(void* _userData, void* _ptr, unsigned int _size) {
+    return static_cast<TessArena*>(_userData)->realloc(_ptr, _size);
 }
 
-void free(void* _userData, void* _ptr) {
-    free(_ptr);
+static void arenaFree(void* _userData, void* _ptr) {}
+
+/* Tesselator reused for all polygons triangulated on a thread
+ *
+ * The tesselator itself sits at the start of the arena; the arena is rewound past it before
+ * each polygon. Bucket sizes follow the largest polygon seen: when a bigger one comes in, the
+ * tesselator is recreated with buckets sized for it so its mesh is built from few allocations
+ */
+class TessContext {
+
+public:
+
+    TESStesselator* get(size_t _numVertices) {
+
+        if (!m_tesselator || (_numVertices > m_sizedFor && m_sizedFor < MAX_BUCKET_SIZE)) {
+            
+            while (m_sizedFor < _numVertices && m_sizedFor < MAX_BUCKET_SIZE) {
+                m_sizedFor *= 2;
+            }
+
+            int size = (int)m_sizedFor;
+            m_alloc = { &arenaAlloc, &arenaRealloc, &arenaFree, &m_arena,
+                        size,                       // meshEdgeBucketSize
+                        size,                       // meshVertexBucketSize
+                        std::max(size / 4, 16),     // meshFaceBucketSize
+                        size,                       // dictNodeBucketSize
+                        std::max(size / 4, 16),     // regionBucketSize
+                        std::max(size / 4, 64)      // extraVertices
+                      };
+
+            m_arena.reset();
+            m_tesselator = tessNewTess(&m_alloc);
+            m_arena.mark();
+
+        } else {
+            m_arena.rewind();
+        }
+
+        return m_tesselator;
+    }
+
+    /* Drops the tesselator, e.g. after a failed tesselation left it in an undefined state */
+    void invalidate() {
+        m_tesselator = nullptr;
+    }
+
+private:
+
+    static const size_t MIN_BUCKET_SIZE = 64;
+    static const size_t MAX_BUCKET_SIZE = 4096;
+
+    TessArena m_arena;
+    TESSalloc m_alloc;
+    TESStesselator* m_tesselator = nullptr;
+    size_t m_sizedFor = MIN_BUCKET_SIZE;
+
+};
+
+static thread_local TessContext tessContext;
+
+#define MAX_EARCLIP_SIZE 64 // Concave rings above this size go to libtess2, ear clipping is quadratic
+
+Triangulation::Triangulation() : m_vertexData(nullptr), m_indexData(nullptr), m_vertexCount(0), m_triangleCount(0) {}
+
+bool Triangulation::triangulate(const Polygon& _polygon) {
+
+    if (_polygon.size() == 1 && triangulateRing(_polygon[0])) {
+        return true;
+    }
+
+    return triangulateTess(_polygon);
 }
 
-static TESSalloc allocator = {&alloc, &realloc, &free, nullptr,
-                              64, // meshEdgeBucketSize
-                              64, // meshVertexBucketSize
-                              16,  // meshFaceBucketSize
-                              64, // dictNodeBucketSize
-                              16,  // regionBucketSize
-                              64  // extraVertices
-                             };
+bool Triangulation::triangulateTess(const Polygon& _polygon) {
 
-void Builders::buildPolygon(const Polygon& _polygon, PolygonBuilder& _ctx) {
-    
-    TESStesselator* tesselator = tessNewTess(&allocator);
-    isect2d::AABB bbox;
-    
-    if (_ctx.useTexCoords && _polygon.size() > 0 && _polygon[0].size() > 0) {
-        // initialize the axis-aligned bounding box of the polygon
-        bbox = isect2d::AABB(_polygon[0][0].x, _polygon[0][0].y, 0, 0);
+    size_t numVertices = 0;
+    for (auto& line : _polygon) {
+        numVertices += line.size();
     }
-    
+
+    TESStesselator* tesselator = tessContext.get(numVertices);
+
     // add polygon contour for every ring
     for (auto& line : _polygon) {
-        if (_ctx.useTexCoords) {
-            for (auto& p : line) {
-                bbox.include(p.x, p.y);
-            }
-        }
         tessAddContour(tesselator, 3, line.data(), sizeof(Point), (int)line.size());
     }
     
-    // call the tesselator
     glm::vec3 normal(0.0, 0.0, 1.0);
     
-    if ( tessTesselate(tesselator, TessWindingRule::TESS_WINDING_NONZERO, TessElementType::TESS_POLYGONS, 3, 3, &normal[0]) ) {
-        
-        const int numElements = tessGetElementCount(tesselator);
-        const TESSindex* tessElements = tessGetElements(tesselator);
-        _ctx.indices.reserve(_ctx.indices.size() + numElements * 3); // Pre-allocate index vector
-        for (int i = 0; i < numElements; i++) {
-            const TESSindex* tessElement = &tessElements[i * 3];
-            for (int j = 0; j < 3; j++) {
-                _ctx.indices.push_back(tessElement[j] + _ctx.numVertices);
+    if (!tessTesselate(tesselator, TessWindingRule::TESS_WINDING_NONZERO, TessElementType::TESS_POLYGONS, 3, 3, &normal[0])) {
+        tessContext.invalidate();
+        return false;
+    }
+
+    m_vertexData = tessGetVertices(tesselator);
+    m_vertexCount = tessGetVertexCount(tesselator);
+    m_indexData = tessGetElements(tesselator);
+    m_triangleCount = tessGetElementCount(tesselator);
+
+    return true;
+}
+
+static float cross2d(const Point& _a, const Point& _b, const Point& _c) {
+    return (_b.x - _a.x) * (_c.y - _a.y) - (_b.y - _a.y) * (_c.x - _a.x);
+}
+
+// Tests if segments AB and CD cross each other
+static bool segmentsIntersect(const Point& _a, const Point& _b, const Point& _c, const Point& _d) {
+    float d1 = cross2d(_c, _d, _a);
+    float d2 = cross2d(_c, _d, _b);
+    float d3 = cross2d(_a, _b, _c);
+    float d4 = cross2d(_a, _b, _d);
+    return ((d1 > 0 && d2 < 0) || (d1 < 0 && d2 > 0)) && ((d3 > 0 && d4 < 0) || (d3 < 0 && d4 > 0));
+}
+
+static bool pointInTriangle(const Point& _p, const Point& _a, const Point& _b, const Point& _c) {
+    return cross2d(_a, _b, _p) >= 0 && cross2d(_b, _c, _p) >= 0 && cross2d(_c, _a, _p) >= 0;
+}
+
+bool Triangulation::triangulateRing(const Line& _ring) {
+
+    int n = (int)_ring.size();
+
+    // rings may repeat their first point at the end
+    if (n > 1 && _ring[0] == _ring[n - 1]) {
+        n--;
+    }
+
+    if (n < 3) {
+        return false;
+    }
+
+    // signed area gives the winding; output triangles are always counter-clockwise
+    float area = 0.f;
+    for (int i = 0, j = n - 1; i < n; j = i++) {
+        area += _ring[j].x * _ring[i].y - _ring[i].x * _ring[j].y;
+    }
+
+    if (area == 0.f) {
+        return false;
+    }
+
+    m_ring.resize(n);
+    for (int i = 0; i < n; i++) {
+        m_ring[i] = area > 0 ? i : n - 1 - i;
+    }
+
+    // convex rings turn in one direction only and sweep around once
+    bool convex = true;
+    int xFlips = 0;
+    float prevDx = 0.f;
+    for (int i = 0; i < n && convex; i++) {
+        const Point& a = _ring[m_ring[i]];
+        const Point& b = _ring[m_ring[(i + 1) % n]];
+        const Point& c = _ring[m_ring[(i + 2) % n]];
+        if (cross2d(a, b, c) < 0) {
+            convex = false;
+        }
+        float dx = b.x - a.x;
+        if (dx != 0) {
+            if (prevDx * dx < 0) {
+                xFlips++;
             }
+            prevDx = dx;
         }
-        
-        const int numVertices = tessGetVertexCount(tesselator);
-        const float* tessVertices = tessGetVertices(tesselator);
+    }
+    // close the sweep with the first non-vertical edge
+    for (int i = 0; i < n; i++) {
+        float dx = _ring[m_ring[(i + 1) % n]].x - _ring[m_ring[i]].x;
+        if (dx != 0) {
+            if (prevDx * dx < 0) {
+                xFlips++;
+            }
+            break;
+        }
+    }
+    convex = convex && xFlips <= 2;
 
-        _ctx.numVertices += numVertices;
-        _ctx.sizeHint(_ctx.numVertices);
+    if (!convex) {
+        if (n > MAX_EARCLIP_SIZE) {
+            return false;
+        }
+        // ear clipping is only valid for simple rings
+        for (int i = 0; i < n; i++) {
+            for (int j = i + 2; j < n; j++) {
+                if (i == 0 && j == n - 1) {
+                    continue; // adjacent edges
+                }
+                if (segmentsIntersect(_ring[i], _ring[i + 1], _ring[j], _ring[(j + 1) % n])) {
+                    return false;
+                }
+            }
+        }
+    }
 
-        for (int i = 0; i < numVertices; i++) {
-            glm::vec3 coord(tessVertices[3*i], tessVertices[3*i+1], tessVertices[3*i+2]);
-            glm::vec2 uv(0);
+    m_indices.clear();
+    m_indices.reserve((n - 2) * 3);
 
-            if (_ctx.useTexCoords) {
-                float u = mapValue(tessVertices[3*i], bbox.m_min.x, bbox.m_max.x, 0., 1.);
-                float v = mapValue(tessVertices[3*i+1], bbox.m_min.y, bbox.m_max.y, 0., 1.);
-                uv = glm::vec2(u, v);
-            }
-            _ctx.addVertex(coord, normal, uv);
+    if (convex) {
+        for (int i = 1; i < n - 1; i++) {
+            m_indices.push_back(m_ring[0]);
+            m_indices.push_back(m_ring[i]);
+            m_indices.push_back(m_ring[i + 1]);
         }
     } else {
-        logMsg("Tesselator cannot tesselate!!\n");
+        // clip one ear at a time until a single triangle is left
+        int remaining = n;
+        int guard = 2 * remaining;
+        for (int v = remaining - 1; remaining > 2; ) {
+            if (guard-- <= 0) {
+                return false; // no ear found, degenerate ring
+            }
+            int u = v < remaining ? v : 0;
+            v = u + 1 < remaining ? u + 1 : 0;
+            int w = v + 1 < remaining ? v + 1 : 0;
+
+            const Point& a = _ring[m_ring[u]];
+            const Point& b = _ring[m_ring[v]];
+            const Point& c = _ring[m_ring[w]];
+
+            if (cross2d(a, b, c) <= 0) {
+                continue; // reflex or flat corner
+            }
+
+            bool isEar = true;
+            for (int p = 0; p < remaining && isEar; p++) {
+                if (p == u || p == v || p == w) { continue; }
+                const Point& pt = _ring[m_ring[p]];
+                if (pt == a || pt == b || pt == c) { continue; }
+                isEar = !pointInTriangle(pt, a, b, c);
+            }
+
+            if (isEar) {
+                m_indices.push_back(m_ring[u]);
+                m_indices.push_back(m_ring[v]);
+                m_indices.push_back(m_ring[w]);
+                m_ring.erase(m_ring.begin() + v);
+                remaining--;
+                guard = 2 * remaining;
+            }
+        }
     }
 
-    tessDeleteTess(tesselator);
+    m_vertices.resize(n * 3);
+    for (int i = 0; i < n; i++) {
+        m_vertices[3*i] = _ring[i].x;
+        m_vertices[3*i+1] = _ring[i].y;
+        m_vertices[3*i+2] = _ring[i].z;
+    }
+
+    m_vertexData = m_vertices.data();
+    m_vertexCount = n;
+    m_indexData = m_indices.data();
+    m_triangleCount = (int)m_indices.size() / 3;
+
+    return true;
 }
 
-void Builders::buildPolygonExtrusion(const Polygon& _polygon, const float& _minHeight, PolygonBuilder& _ctx) {
-    
-    int vertexDataOffset = (int)_ctx.numVertices;
-    
-    glm::vec3 upVector(0.0f, 0.0f, 1.0f);
-    glm::vec3 normalVector;
-    
-    for (auto& line : _polygon) {
-        
-        size_t lineSize = line.size();
-        _ctx.indices.reserve(_ctx.indices.size() + lineSize * 6); // Pre-allocate index vector
+void Builders::polyLineSize(size_t _lineSize, const PolyLineOptions& _options, size_t& _numVertices, size_t& _numIndices) {
 
-        _ctx.numVertices += (lineSize - 1) * 4;
-        _ctx.sizeHint(_ctx.numVertices);
+    _numVertices = 0;
+    _numIndices = 0;
 
-        for (size_t i = 0; i < lineSize - 1; i++) {
-            
-            normalVector = glm::cross(upVector, (line[i+1] - line[i]));
-            normalVector = glm::normalize(normalVector);
-            
-            // 1st vertex top
-            _ctx.addVertex(line[i], normalVector, glm::vec2(1.,0.));
+    if (_lineSize < 2) {
+        return;
+    }
 
-            // 2nd vertex top
-            _ctx.addVertex(line[i+1], normalVector, glm::vec2(0.,0.));
+    size_t cornersOnCap = (size_t)_options.cap;
+    size_t trianglesOnJoin = (size_t)_options.join;
 
-            // 1st vertex bottom
-            _ctx.addVertex(glm::vec3(line[i].x, line[i].y, _minHeight),
-                           normalVector, glm::vec2(1.,1.));
+    // first and last point, the last closes a segment
+    _numVertices += 4;
+    _numIndices += 6;
 
-            // 2nd vertex bottom
-            _ctx.addVertex(glm::vec3(line[i+1].x, line[i+1].y, _minHeight),
-                           normalVector, glm::vec2(0.,1.));
+    // intermediate points close a segment, fan joins add a fan and restart the segment
+    if (trianglesOnJoin == 0) {
+        _numVertices += (_lineSize - 2) * 2;
+        _numIndices += (_lineSize - 2) * 6;
+    } else {
+        _numVertices += (_lineSize - 2) * (6 + trianglesOnJoin);
+        _numIndices += (_lineSize - 2) * (6 + 3 * trianglesOnJoin);
+    }
 
-            // Start the index from the previous state of the vertex Data
-            _ctx.indices.push_back(vertexDataOffset);
-            _ctx.indices.push_back(vertexDataOffset + 1);
-            _ctx.indices.push_back(vertexDataOffset + 2);
-            
-            _ctx.indices.push_back(vertexDataOffset + 1);
-            _ctx.indices.push_back(vertexDataOffset + 3);
-            _ctx.indices.push_back(vertexDataOffset + 2);
-            
-            vertexDataOffset += 4;
-        }
+    // caps, see addCap()
+    if (cornersOnCap == 2) {
+        // square caps only form triangles at the end of the line
+        _numVertices += 4;
+        _numIndices += 6;
+    } else if (cornersOnCap > 0) {
+        // round caps are a fan of cornersOnCap triangles at each end
+        _numVertices += 2 * (2 + cornersOnCap);
+        _numIndices += 2 * 3 * cornersOnCap;
     }
 }
 
 // Get 2D perpendicular of two points
-glm::vec2 perp2d(const glm::vec3& _v1, const glm::vec3& _v2 ){
+glm::vec2 Builders::perp2d(const glm::vec3& _v1, const glm::vec3& _v2 ){
     return glm::vec2(_v2.y - _v1.y, _v1.x - _v2.x);
 }
 
-// Helper function for polyline tesselation
-inline void addPolyLineVertex(const glm::vec3& _coord, const glm::vec2& _normal, const glm::vec2& _uv, PolyLineBuilder& _ctx) {
-    _ctx.numVertices++;
-    _ctx.addVertex(_coord, _normal, _uv);
-}
-
 // Helper function for polyline tesselation; adds indices for pairs of vertices arranged like a line strip
-void indexPairs( int _nPairs, int _nVertices, std::vector<int>& _indicesOut) {
+void Builders::indexPairs(int _nPairs, int _nVertices, std::vector<int>& _indicesOut) {
     for (int i = 0; i < _nPairs; i++) {
         _indicesOut.push_back(_nVertices - 2*i - 4);
         _indicesOut.push_back(_nVertices - 2*i - 2);
@@ -159,80 +417,12 @@ void indexPairs( int _nPairs, int _nVertices, std::vector<int>& _indicesOut) {
     }
 }
 
-//  Tessalate a fan geometry between points A       B
-//  using their normals from a center        \ . . /
-//  and interpolating their UVs               \ p /
-//                                             \./
-//                                              C
-void addFan(const glm::vec3& _pC,
-            const glm::vec2& _nA, const glm::vec2& _nB, const glm::vec2& _nC,
-            const glm::vec2& _uA, const glm::vec2& _uB, const glm::vec2& _uC,
-            int _numTriangles, PolyLineBuilder& _ctx) {
-    
-    // Find angle difference
-    float cross = _nA.x * _nB.y - _nA.y * _nB.x; // z component of cross(_CA, _CB)
-    float angle = atan2f(cross, glm::dot(_nA, _nB));
-    
-    int startIndex = _ctx.numVertices;
-    
-    // Add center vertex
-    addPolyLineVertex(_pC, _nC, _uC, _ctx);
-    
-    // Add vertex for point A
-    addPolyLineVertex(_pC, _nA, _uA, _ctx);
-    
-    // Add radial vertices
-    glm::vec2 radial = _nA;
-    for (int i = 0; i < _numTriangles; i++) {
-        float frac = (i + 1)/(float)_numTriangles;
-        radial = glm::rotate(_nA, angle * frac);
-        glm::vec2 uv = (1.f - frac) * _uA + frac * _uB;
-        addPolyLineVertex(_pC, radial, uv, _ctx);
-        
-        // Add indices
-        _ctx.indices.push_back(startIndex); // center vertex
-        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 1 : 2));
-        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 2 : 1));
-    }
-    
-}
-
-// Function to add the vertices for line caps
-void addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners, bool _isBeginning, PolyLineBuilder& _ctx) {
-
-    float v = _isBeginning ? 0.f : 1.f; // length-wise tex coord
-    
-    if (_numCorners < 1) {
-        // "Butt" cap needs no extra vertices
-        return;
-    } else if (_numCorners == 2) {
-        // "Square" cap needs two extra vertices
-        glm::vec2 tangent(-_normal.y, _normal.x);
-        addPolyLineVertex(_coord, _normal + tangent, {0.f, v}, _ctx);
-        addPolyLineVertex(_coord, -_normal + tangent, {0.f, v}, _ctx);
-        if (!_isBeginning) { // At the beginning of a line we can't form triangles with previous vertices
-            indexPairs(1, _ctx.numVertices, _ctx.indices);
-        }
-        return;
-    }
-    
-    // "Round" cap type needs a fan of vertices
-    glm::vec2 nA(_normal), nB(-_normal), nC(0.f, 0.f), uA(1.f, v), uB(0.f, v), uC(0.5f, v);
-    if (_isBeginning) {
-        nA *= -1.f; // To flip the direction of the fan, we negate the normal vectors
-        nB *= -1.f;
-        uA.x = 0.f; // To keep tex coords consistent, we must reverse these too
-        uB.x = 1.f;
-    }
-    addFan(_coord, nA, nB, nC, uA, uB, uC, _numCorners, _ctx);
-}
-
-float valuesWithinTolerance(float _a, float _b, float _tolerance = 0.001) {
+static bool valuesWithinTolerance(float _a, float _b, float _tolerance = 0.001) {
     return fabsf(_a - _b) < _tolerance;
 }
 
 // Tests if a line segment (from point A to B) is nearly coincident with the edge of a tile
-bool isOnTileEdge(const glm::vec3& _pa, const glm::vec3& _pb) {
+bool Builders::isOnTileEdge(const glm::vec3& _pa, const glm::vec3& _pb) {
     
     float tolerance = 0.0002; // tweak this adjust if catching too few/many line segments near tile edges
     // TODO: make tolerance configurable by source if necessary
@@ -244,112 +434,3 @@ bool isOnTileEdge(const glm::vec3& _pa, const glm::vec3& _pb) {
            (valuesWithinTolerance(_pa.y, tile_min.y, tolerance) && valuesWithinTolerance(_pb.y, tile_min.y, tolerance)) ||
            (valuesWithinTolerance(_pa.y, tile_max.y, tolerance) && valuesWithinTolerance(_pb.y, tile_max.y, tolerance));
 }
-
-void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx) {
-    
-    int lineSize = (int)_line.size();
-    
-    if (lineSize < 2) {
-        return;
-    }
-    
-    // TODO: pre-allocate context vectors; try estimating worst-case space usage
-    
-    glm::vec3 coordPrev(_line[0]), coordCurr(_line[0]), coordNext(_line[1]);
-    glm::vec2 normPrev, normNext, miterVec;
-
-    int cornersOnCap = (int)_ctx.options.cap;
-    int trianglesOnJoin = (int)_ctx.options.join;
-    
-    // Process first point in line with an end cap
-    normNext = glm::normalize(perp2d(coordCurr, coordNext));
-    addCap(coordCurr, normNext, cornersOnCap, true, _ctx);
-    addPolyLineVertex(coordCurr, normNext, {1.0f, 0.0f}, _ctx); // right corner
-    addPolyLineVertex(coordCurr, -normNext, {0.0f, 0.0f}, _ctx); // left corner
-    
-    // Process intermediate points
-    for (int i = 1; i < lineSize - 1; i++) {
-
-        coordPrev = coordCurr;
-        coordCurr = coordNext;
-        coordNext = _line[i + 1];
-        
-        normPrev = normNext;
-        normNext = glm::normalize(perp2d(coordCurr, coordNext));
-
-        // Compute "normal" for miter joint
-        miterVec = normPrev + normNext;
-        float scale = sqrtf(2.0f / (1.0f + glm::dot(normPrev, normNext)) / glm::dot(miterVec, miterVec) );
-        miterVec *= fminf(scale, 5.0f); // clamps our miter vector to an arbitrary length
-        
-        float v = i / (float)lineSize;
-        
-        if (trianglesOnJoin == 0) {
-            // Join type is a simple miter
-            
-            addPolyLineVertex(coordCurr, miterVec, {1.0, v}, _ctx); // right corner
-            addPolyLineVertex(coordCurr, -miterVec, {0.0, v}, _ctx); // left corner
-            indexPairs(1, _ctx.numVertices, _ctx.indices);
-            
-        } else {
-            // Join type is a fan of triangles
-            
-            bool isRightTurn = (normNext.x * normPrev.y - normNext.y * normPrev.x) > 0; // z component of cross(normNext, normPrev)
-            
-            if (isRightTurn) {
-                
-                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
-                addPolyLineVertex(coordCurr, -normPrev, {0.0f, v}, _ctx); // left (outer) corner
-                indexPairs(1, _ctx.numVertices, _ctx.indices);
-                
-                addFan(coordCurr, -normPrev, -normNext, miterVec, {0.f, v}, {0.f, v}, {1.f, v}, trianglesOnJoin, _ctx);
-                
-                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
-                addPolyLineVertex(coordCurr, -normNext, {0.0f, v}, _ctx); // left (outer) corner
-                
-            } else {
-                
-                addPolyLineVertex(coordCurr, normPrev, {1.0f, v}, _ctx); // right (outer) corner
-                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
-                indexPairs(1, _ctx.numVertices, _ctx.indices);
-                
-                addFan(coordCurr, normPrev, normNext, -miterVec, {1.f, v}, {1.f, v}, {0.0f, v}, trianglesOnJoin, _ctx);
-                
-                addPolyLineVertex(coordCurr, normNext, {1.0f, v}, _ctx); // right (outer) corner
-                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
-                
-            }
-            
-        }
-    }
-    
-    // Process last point in line with a cap
-    addPolyLineVertex(coordNext, normNext, {1.f, 1.f}, _ctx); // right corner
-    addPolyLineVertex(coordNext, -normNext, {0.f, 1.f}, _ctx); // left corner
-    indexPairs(1, _ctx.numVertices, _ctx.indices);
-    addCap(coordNext, normNext, cornersOnCap , false, _ctx);
-    
-}
-
-void Builders::buildOutline(const Line& _line, PolyLineBuilder& _ctx) {
-    
-    int cut = 0;
-    
-    for (size_t i = 0; i < _line.size() - 1; i++) {
-        const glm::vec3& coordCurr = _line[i];
-        const glm::vec3& coordNext = _line[i+1];
-        if (isOnTileEdge(coordCurr, coordNext)) {
-            Line line = Line(&_line[cut], &_line[i+1]);
-            buildPolyLine(line, _ctx);
-            cut = i + 1;
-        }
-    }
-    
-    Line line = Line(&_line[cut], &_line[_line.size()]);
-    buildPolyLine(line, _ctx);
-    
-}
-
-void Builders::buildQuadAtPoint(const Point& _point, const glm::vec3& _normal, float halfWidth, float height, PolygonBuilder& _ctx) {
-
-}
@@ -1,9 +1,12 @@
 #pragma once
 
 #include <vector>
+#include <cmath>
 
 #include "tileData.h"
 #include "platform.h"
+#include "geom.h"
+#include "glm/gtx/rotate_vector.hpp"
 
 enum class CapTypes {
     BUTT = 0, // No points added to end of line
@@ -25,50 +28,101 @@ struct PolyLineOptions {
     PolyLineOptions(CapTypes _c, JoinTypes _j) : cap(_c), join(_j) {};
 };
 
-/* Callback function for PolygonBuilder:
- *
- * @coord  tesselated output coordinate
- * @normal triangle plane normal
- * @uv     texture coordinate of the output coordinate
- */
-typedef std::function<void(const glm::vec3& coord, const glm::vec3& normal, const glm::vec2& uv)> PolygonVertexFn;
-
-typedef std::function<void(size_t reserve)> SizeHintFn;
-
 /* PolygonBuilder context,
  * see Builders::buildPolygon() and Builders::buildPolygonExtrusion()
+ *
+ * @VertexFn   functor adding one output vertex, called as addVertex(coord, normal, uv) with
+ *             @coord  tesselated output coordinate
+ *             @normal triangle plane normal
+ *             @uv     texture coordinate of the output coordinate
+ * @SizeHintFn functor called as sizeHint(numVertices) with the total number of vertices the builder
+ *             will have added once the current geometry is emitted, before any of its vertices are added
+ *
+ * Builders are templates on these functors so that vertices are written by inlined code directly into
+ * the output buffer; use makePolygonBuilder() to construct one from lambdas
  */
+template<class VertexFn, class SizeHintFn>
 struct PolygonBuilder {
     std::vector<int> indices; // indices for drawing the polyon as triangles are added to this vector
-    PolygonVertexFn addVertex;
+    VertexFn addVertex;
     SizeHintFn sizeHint;
     size_t numVertices = 0;
     bool useTexCoords;
 
-    PolygonBuilder(PolygonVertexFn _addVertex, SizeHintFn _sizeHint, bool _useTexCoords = true)
+    PolygonBuilder(VertexFn _addVertex, SizeHintFn _sizeHint, bool _useTexCoords = true)
         : addVertex(_addVertex), sizeHint(_sizeHint), useTexCoords(_useTexCoords){}
 };
 
-
-/* Callback function for PolyLineBuilder:
- *
- * @coord   tesselated output coordinate
- * @enormal extrusion vector of the output coordinate
- * @uv      texture coordinate of the output coordinate
- */
-typedef std::function<void(const glm::vec3& coord, const glm::vec2& enormal, const glm::vec2& uv)> PolyLineVertexFn;
+template<class VertexFn, class SizeHintFn>
+PolygonBuilder<VertexFn, SizeHintFn> makePolygonBuilder(VertexFn _addVertex, SizeHintFn _sizeHint, bool _useTexCoords = true) {
+    return PolygonBuilder<VertexFn, SizeHintFn>(_addVertex, _sizeHint, _useTexCoords);
+}
 
 /* PolyLineBuilder context,
  * see Builders::buildPolyLine()
+ *
+ * @VertexFn   functor adding one output vertex, called as addVertex(coord, enormal, uv) with
+ *             @coord   tesselated output coordinate
+ *             @enormal extrusion vector of the output coordinate
+ *             @uv      texture coordinate of the output coordinate
+ * @SizeHintFn functor called as sizeHint(numVertices) with the total number of vertices the builder
+ *             will have added once the current line is emitted, before any of its vertices are added
+ *
+ * Use makePolyLineBuilder() to construct one from lambdas
  */
+template<class VertexFn, class SizeHintFn>
 struct PolyLineBuilder {
     PolyLineOptions options;
     std::vector<int> indices; // indices for drawing the polyline as triangles are added to this vector
-    PolyLineVertexFn addVertex;
+    VertexFn addVertex;
+    SizeHintFn sizeHint;
     size_t numVertices = 0;
 
-    PolyLineBuilder(PolyLineVertexFn _addVertex, PolyLineOptions _options = PolyLineOptions())
-        : options(_options), addVertex(_addVertex){}
+    PolyLineBuilder(VertexFn _addVertex, SizeHintFn _sizeHint, PolyLineOptions _options = PolyLineOptions())
+        : options(_options), addVertex(_addVertex), sizeHint(_sizeHint){}
+};
+
+template<class VertexFn, class SizeHintFn>
+PolyLineBuilder<VertexFn, SizeHintFn> makePolyLineBuilder(VertexFn _addVertex, SizeHintFn _sizeHint, PolyLineOptions _options = PolyLineOptions()) {
+    return PolyLineBuilder<VertexFn, SizeHintFn>(_addVertex, _sizeHint, _options);
+}
+
+/* Triangulation of a polygon; holds the output of the triangulator until it has been emitted
+ *
+ * Polygons made of a single simple ring are triangulated directly, as a fan when convex or by
+ * ear clipping otherwise; polygons with holes, self-intersecting or large concave rings fall back
+ * to libtess2. libtess2 output lives in a per-thread arena and stays valid until the next polygon
+ * is triangulated on the same thread
+ */
+class Triangulation {
+
+public:
+
+    Triangulation();
+
+    /* Triangulates _polygon with the nonzero winding rule, returns false on failure */
+    bool triangulate(const Polygon& _polygon);
+
+    int vertexCount() const { return m_vertexCount; }
+    const float* vertices() const { return m_vertexData; } // 3 coordinates per vertex
+    int triangleCount() const { return m_triangleCount; }
+    const int* indices() const { return m_indexData; } // 3 vertex indices per triangle, counter-clockwise
+
+private:
+
+    bool triangulateRing(const Line& _ring);
+    bool triangulateTess(const Polygon& _polygon);
+
+    // output of the fast path
+    std::vector<float> m_vertices;
+    std::vector<int> m_indices;
+    std::vector<int> m_ring;
+
+    const float* m_vertexData;
+    const int* m_indexData;
+    int m_vertexCount;
+    int m_triangleCount;
+
 };
 
 class Builders {
@@ -79,29 +133,351 @@ public:
      * @_polygon input coordinates describing the polygon
      * @_ctx output vectors, see <PolygonBuilder>
      */
-    static void buildPolygon(const Polygon& _polygon, PolygonBuilder& _ctx);
+    template<class VertexFn, class SizeHintFn>
+    static void buildPolygon(const Polygon& _polygon, PolygonBuilder<VertexFn, SizeHintFn>& _ctx);
 
     /* Build extruded 'walls' from a polygon
      * @_polygon input coordinates describing the polygon
      * @_minHeight the extrusion will extend from this z coordinate to the z of the polygon points
      * @_ctx output vectors, see <PolygonBuilder>
      */
-    static void buildPolygonExtrusion(const Polygon& _polygon, const float& _minHeight, PolygonBuilder& _ctx);
+    template<class VertexFn, class SizeHintFn>
+    static void buildPolygonExtrusion(const Polygon& _polygon, const float& _minHeight, PolygonBuilder<VertexFn, SizeHintFn>& _ctx);
 
     /* Build a tesselated polygon line of fixed width from line coordinates
      * @_line input coordinates describing the line
      * @_options parameters for polyline construction
      * @_ctx output vectors, see <PolyLineBuilder>
      */
-    static void buildPolyLine(const Line& _line, PolyLineBuilder& _ctx);
+    template<class VertexFn, class SizeHintFn>
+    static void buildPolyLine(const Line& _line, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx);
     
     /* Build a tesselated outline that follows the given line while skipping tile boundaries */
-    static void buildOutline(const Line& _line, PolyLineBuilder& _ctx);
+    template<class VertexFn, class SizeHintFn>
+    static void buildOutline(const Line& _line, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx);
+
+    /* Compute the exact number of vertices and indices buildPolyLine() emits for a line
+     * @_lineSize number of points in the line
+     * @_options cap and join types of the line
+     * @_numVertices @_numIndices output counts
+     */
+    static void polyLineSize(size_t _lineSize, const PolyLineOptions& _options, size_t& _numVertices, size_t& _numIndices);
     
     /* Build a tesselated square centered on a point coordinate
      * 
      * NOT IMPLEMENTED
      */
-    static void buildQuadAtPoint(const Point& _pointIn, const glm::vec3& _normal, float width, float height, PolygonBuilder& _ctx);
+    template<class VertexFn, class SizeHintFn>
+    static void buildQuadAtPoint(const Point& _pointIn, const glm::vec3& _normal, float width, float height, PolygonBuilder<VertexFn, SizeHintFn>& _ctx) {}
     
+private:
+
+    // Helper functions for polyline tesselation
+
+    template<class VertexFn, class SizeHintFn>
+    static void addPolyLineVertex(const glm::vec3& _coord, const glm::vec2& _normal, const glm::vec2& _uv, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx);
+
+    template<class VertexFn, class SizeHintFn>
+    static void addFan(const glm::vec3& _pC,
+                       const glm::vec2& _nA, const glm::vec2& _nB, const glm::vec2& _nC,
+                       const glm::vec2& _uA, const glm::vec2& _uB, const glm::vec2& _uC,
+                       int _numTriangles, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx);
+
+    template<class VertexFn, class SizeHintFn>
+    static void addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners, bool _isBeginning, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx);
+
+    static glm::vec2 perp2d(const glm::vec3& _v1, const glm::vec3& _v2);
+
+    static void indexPairs(int _nPairs, int _nVertices, std::vector<int>& _indicesOut);
+
+    static bool isOnTileEdge(const glm::vec3& _pa, const glm::vec3& _pb);
+
 };
+
+template<class VertexFn, class SizeHintFn>
+void Builders::buildPolygon(const Polygon& _polygon, PolygonBuilder<VertexFn, SizeHintFn>& _ctx) {
+    
+    glm::vec2 bboxMin, bboxMax;
+    
+    if (_ctx.useTexCoords && _polygon.size() > 0 && _polygon[0].size() > 0) {
+        // compute the axis-aligned bounding box of the polygon
+        bboxMin = bboxMax = glm::vec2(_polygon[0][0].x, _polygon[0][0].y);
+        for (auto& line : _polygon) {
+            for (auto& p : line) {
+                bboxMin = glm::min(bboxMin, glm::vec2(p.x, p.y));
+                bboxMax = glm::max(bboxMax, glm::vec2(p.x, p.y));
+            }
+        }
+    }
+    
+    // call the tesselator
+    Triangulation triangulation;
+    
+    if (triangulation.triangulate(_polygon)) {
+        
+        glm::vec3 normal(0.0, 0.0, 1.0);
+        
+        const int numElements = triangulation.triangleCount();
+        const int* elements = triangulation.indices();
+        _ctx.indices.reserve(_ctx.indices.size() + numElements * 3); // Pre-allocate index vector
+        for (int i = 0; i < numElements * 3; i++) {
+            _ctx.indices.push_back(elements[i] + _ctx.numVertices);
+        }
+        
+        const int numVertices = triangulation.vertexCount();
+        const float* vertices = triangulation.vertices();
+
+        _ctx.numVertices += numVertices;
+        _ctx.sizeHint(_ctx.numVertices);
+
+        for (int i = 0; i < numVertices; i++) {
+            glm::vec3 coord(vertices[3*i], vertices[3*i+1], vertices[3*i+2]);
+            glm::vec2 uv(0);
+
+            if (_ctx.useTexCoords) {
+                float u = mapValue(vertices[3*i], bboxMin.x, bboxMax.x, 0., 1.);
+                float v = mapValue(vertices[3*i+1], bboxMin.y, bboxMax.y, 0., 1.);
+                uv = glm::vec2(u, v);
+            }
+            _ctx.addVertex(coord, normal, uv);
+        }
+    } else {
+        logMsg("Tesselator cannot tesselate!!\n");
+    }
+}
+
+template<class VertexFn, class SizeHintFn>
+void Builders::buildPolygonExtrusion(const Polygon& _polygon, const float& _minHeight, PolygonBuilder<VertexFn, SizeHintFn>& _ctx) {
+    
+    int vertexDataOffset = (int)_ctx.numVertices;
+    
+    glm::vec3 upVector(0.0f, 0.0f, 1.0f);
+    glm::vec3 normalVector;
+    
+    for (auto& line : _polygon) {
+        
+        size_t lineSize = line.size();
+        _ctx.indices.reserve(_ctx.indices.size() + lineSize * 6); // Pre-allocate index vector
+
+        _ctx.numVertices += (lineSize - 1) * 4;
+        _ctx.sizeHint(_ctx.numVertices);
+
+        for (size_t i = 0; i < lineSize - 1; i++) {
+            
+            normalVector = glm::cross(upVector, (line[i+1] - line[i]));
+            normalVector = glm::normalize(normalVector);
+            
+            // 1st vertex top
+            _ctx.addVertex(line[i], normalVector, glm::vec2(1.,0.));
+
+            // 2nd vertex top
+            _ctx.addVertex(line[i+1], normalVector, glm::vec2(0.,0.));
+
+            // 1st vertex bottom
+            _ctx.addVertex(glm::vec3(line[i].x, line[i].y, _minHeight),
+                           normalVector, glm::vec2(1.,1.));
+
+            // 2nd vertex bottom
+            _ctx.addVertex(glm::vec3(line[i+1].x, line[i+1].y, _minHeight),
+                           normalVector, glm::vec2(0.,1.));
+
+            // Start the index from the previous state of the vertex Data
+            _ctx.indices.push_back(vertexDataOffset);
+            _ctx.indices.push_back(vertexDataOffset + 1);
+            _ctx.indices.push_back(vertexDataOffset + 2);
+            
+            _ctx.indices.push_back(vertexDataOffset + 1);
+            _ctx.indices.push_back(vertexDataOffset + 3);
+            _ctx.indices.push_back(vertexDataOffset + 2);
+            
+            vertexDataOffset += 4;
+        }
+    }
+}
+
+template<class VertexFn, class SizeHintFn>
+void Builders::addPolyLineVertex(const glm::vec3& _coord, const glm::vec2& _normal, const glm::vec2& _uv, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx) {
+    _ctx.numVertices++;
+    _ctx.addVertex(_coord, _normal, _uv);
+}
+
+//  Tessalate a fan geometry between points A       B
+//  using their normals from a center        \ . . /
+//  and interpolating their UVs               \ p /
+//                                             \./
+//                                              C
+template<class VertexFn, class SizeHintFn>
+void Builders::addFan(const glm::vec3& _pC,
+                      const glm::vec2& _nA, const glm::vec2& _nB, const glm::vec2& _nC,
+                      const glm::vec2& _uA, const glm::vec2& _uB, const glm::vec2& _uC,
+                      int _numTriangles, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx) {
+    
+    // Find angle difference
+    float cross = _nA.x * _nB.y - _nA.y * _nB.x; // z component of cross(_CA, _CB)
+    float angle = atan2f(cross, glm::dot(_nA, _nB));
+    
+    int startIndex = _ctx.numVertices;
+    
+    // Add center vertex
+    addPolyLineVertex(_pC, _nC, _uC, _ctx);
+    
+    // Add vertex for point A
+    addPolyLineVertex(_pC, _nA, _uA, _ctx);
+    
+    // Add radial vertices
+    glm::vec2 radial = _nA;
+    for (int i = 0; i < _numTriangles; i++) {
+        float frac = (i + 1)/(float)_numTriangles;
+        radial = glm::rotate(_nA, angle * frac);
+        glm::vec2 uv = (1.f - frac) * _uA + frac * _uB;
+        addPolyLineVertex(_pC, radial, uv, _ctx);
+        
+        // Add indices
+        _ctx.indices.push_back(startIndex); // center vertex
+        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 1 : 2));
+        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 2 : 1));
+    }
+    
+}
+
+// Function to add the vertices for line caps
+template<class VertexFn, class SizeHintFn>
+void Builders::addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners, bool _isBeginning, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx) {
+
+    float v = _isBeginning ? 0.f : 1.f; // length-wise tex coord
+    
+    if (_numCorners < 1) {
+        // "Butt" cap needs no extra vertices
+        return;
+    } else if (_numCorners == 2) {
+        // "Square" cap needs two extra vertices
+        glm::vec2 tangent(-_normal.y, _normal.x);
+        addPolyLineVertex(_coord, _normal + tangent, {0.f, v}, _ctx);
+        addPolyLineVertex(_coord, -_normal + tangent, {0.f, v}, _ctx);
+        if (!_isBeginning) { // At the beginning of a line we can't form triangles with previous vertices
+            indexPairs(1, _ctx.numVertices, _ctx.indices);
+        }
+        return;
+    }
+    
+    // "Round" cap type needs a fan of vertices
+    glm::vec2 nA(_normal), nB(-_normal), nC(0.f, 0.f), uA(1.f, v), uB(0.f, v), uC(0.5f, v);
+    if (_isBeginning) {
+        nA *= -1.f; // To flip the direction of the fan, we negate the normal vectors
+        nB *= -1.f;
+        uA.x = 0.f; // To keep tex coords consistent, we must reverse these too
+        uB.x = 1.f;
+    }
+    addFan(_coord, nA, nB, nC, uA, uB, uC, _numCorners, _ctx);
+}
+
+template<class VertexFn, class SizeHintFn>
+void Builders::buildPolyLine(const Line& _line, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx) {
+    
+    int lineSize = (int)_line.size();
+    
+    if (lineSize < 2) {
+        return;
+    }
+    
+    size_t numVertices, numIndices;
+    polyLineSize(lineSize, _ctx.options, numVertices, numIndices);
+
+    _ctx.indices.reserve(_ctx.indices.size() + numIndices); // Pre-allocate index vector
+    _ctx.sizeHint(_ctx.numVertices + numVertices);
+
+    glm::vec3 coordPrev(_line[0]), coordCurr(_line[0]), coordNext(_line[1]);
+    glm::vec2 normPrev, normNext, miterVec;
+
+    int cornersOnCap = (int)_ctx.options.cap;
+    int trianglesOnJoin = (int)_ctx.options.join;
+    
+    // Process first point in line with an end cap
+    normNext = glm::normalize(perp2d(coordCurr, coordNext));
+    addCap(coordCurr, normNext, cornersOnCap, true, _ctx);
+    addPolyLineVertex(coordCurr, normNext, {1.0f, 0.0f}, _ctx); // right corner
+    addPolyLineVertex(coordCurr, -normNext, {0.0f, 0.0f}, _ctx); // left corner
+    
+    // Process intermediate points
+    for (int i = 1; i < lineSize - 1; i++) {
+
+        coordPrev = coordCurr;
+        coordCurr = coordNext;
+        coordNext = _line[i + 1];
+        
+        normPrev = normNext;
+        normNext = glm::normalize(perp2d(coordCurr, coordNext));
+
+        // Compute "normal" for miter joint
+        miterVec = normPrev + normNext;
+        float scale = sqrtf(2.0f / (1.0f + glm::dot(normPrev, normNext)) / glm::dot(miterVec, miterVec) );
+        miterVec *= fminf(scale, 5.0f); // clamps our miter vector to an arbitrary length
+        
+        float v = i / (float)lineSize;
+        
+        if (trianglesOnJoin == 0) {
+            // Join type is a simple miter
+            
+            addPolyLineVertex(coordCurr, miterVec, {1.0, v}, _ctx); // right corner
+            addPolyLineVertex(coordCurr, -miterVec, {0.0, v}, _ctx); // left corner
+            indexPairs(1, _ctx.numVertices, _ctx.indices);
+            
+        } else {
+            // Join type is a fan of triangles
+            
+            bool isRightTurn = (normNext.x * normPrev.y - normNext.y * normPrev.x) > 0; // z component of cross(normNext, normPrev)
+            
+            if (isRightTurn) {
+                
+                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
+                addPolyLineVertex(coordCurr, -normPrev, {0.0f, v}, _ctx); // left (outer) corner
+                indexPairs(1, _ctx.numVertices, _ctx.indices);
+                
+                addFan(coordCurr, -normPrev, -normNext, miterVec, {0.f, v}, {0.f, v}, {1.f, v}, trianglesOnJoin, _ctx);
+                
+                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx); // right (inner) corner
+                addPolyLineVertex(coordCurr, -normNext, {0.0f, v}, _ctx); // left (outer) corner
+                
+            } else {
+                
+                addPolyLineVertex(coordCurr, normPrev, {1.0f, v}, _ctx); // right (outer) corner
+                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
+                indexPairs(1, _ctx.numVertices, _ctx.indices);
+                
+                addFan(coordCurr, normPrev, normNext, -miterVec, {1.f, v}, {1.f, v}, {0.0f, v}, trianglesOnJoin, _ctx);
+                
+                addPolyLineVertex(coordCurr, normNext, {1.0f, v}, _ctx); // right (outer) corner
+                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx); // left (inner) corner
+                
+            }
+            
+        }
+    }
+    
+    // Process last point in line with a cap
+    addPolyLineVertex(coordNext, normNext, {1.f, 1.f}, _ctx); // right corner
+    addPolyLineVertex(coordNext, -normNext, {0.f, 1.f}, _ctx); // left corner
+    indexPairs(1, _ctx.numVertices, _ctx.indices);
+    addCap(coordNext, normNext, cornersOnCap , false, _ctx);
+    
+}
+
+template<class VertexFn, class SizeHintFn>
+void Builders::buildOutline(const Line& _line, PolyLineBuilder<VertexFn, SizeHintFn>& _ctx) {
+    
+    int cut = 0;
+    
+    for (size_t i = 0; i < _line.size() - 1; i++) {
+        const glm::vec3& coordCurr = _line[i];
+        const glm::vec3& coordNext = _line[i+1];
+        if (isOnTileEdge(coordCurr, coordNext)) {
+            Line line = Line(&_line[cut], &_line[i+1]);
+            buildPolyLine(line, _ctx);
+            cut = i + 1;
+        }
+    }
+    
+    Line line = Line(&_line[cut], &_line[_line.size()]);
+    buildPolyLine(line, _ctx);
+    
+}
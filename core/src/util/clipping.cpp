@@ -0,0 +1,289 @@
+#include "clipping.h"
+
+#include <algorithm>
+#include <cmath>
+
+void Clipping::clipLine(const Line& _line, float _min, float _max, std::vector<Line>& _out) {
+    
+    Line* current = nullptr; // visible line being built, nullptr while outside of the square
+    
+    for (size_t i = 0; i + 1 < _line.size(); i++) {
+        
+        const Point& p0 = _line[i];
+        const Point& p1 = _line[i + 1];
+        Point d = p1 - p0;
+        
+        // Liang-Barsky: intersect the parametric segment p0 + t * d, t in [0, 1] with each boundary
+        const float p[4] = { -d.x, d.x, -d.y, d.y };
+        const float q[4] = { p0.x - _min, _max - p0.x, p0.y - _min, _max - p0.y };
+        
+        float t0 = 0.f;
+        float t1 = 1.f;
+        bool visible = true;
+        
+        for (int k = 0; k < 4 && visible; k++) {
+            if (p[k] == 0.f) {
+                // segment is parallel to this boundary, and entirely outside of it if q < 0
+                visible = q[k] >= 0.f;
+            } else {
+                float t = q[k] / p[k];
+                if (p[k] < 0.f) {
+                    t0 = std::max(t0, t);
+                } else {
+                    t1 = std::min(t1, t);
+                }
+                visible = t0 <= t1;
+            }
+        }
+        
+        if (!visible) {
+            current = nullptr;
+            continue;
+        }
+        
+        if (current == nullptr || t0 > 0.f) {
+            _out.emplace_back();
+            current = &_out.back();
+            current->push_back(p0 + d * t0);
+        }
+        
+        current->push_back(p0 + d * t1);
+        
+        if (t1 < 1.f) {
+            // segment leaves the square, the next visible part starts a new line
+            current = nullptr;
+        }
+    }
+    
+}
+
+void Clipping::clipRing(const Line& _ring, float _min, float _max, Line& _out) {
+    
+    _out.clear();
+    
+    if (_ring.size() < 3) {
+        return;
+    }
+    
+    bool closed = _ring.front() == _ring.back();
+    
+    // Sutherland-Hodgman: clip the ring successively against each of the four boundaries
+    Line input(_ring.begin(), closed ? _ring.end() - 1 : _ring.end());
+    Line output;
+    output.reserve(input.size() + 4);
+    
+    for (int edge = 0; edge < 4 && !input.empty(); edge++) {
+        
+        int axis = edge / 2; // 0: x, 1: y
+        bool isMin = (edge % 2) == 0;
+        float bound = isMin ? _min : _max;
+        
+        auto inside = [&](const Point& _p) {
+            return isMin ? _p[axis] >= bound : _p[axis] <= bound;
+        };
+        
+        auto intersect = [&](const Point& _a, const Point& _b) {
+            float t = (bound - _a[axis]) / (_b[axis] - _a[axis]);
+            return _a + (_b - _a) * t;
+        };
+        
+        output.clear();
+        
+        const Point* prev = &input.back();
+        bool prevInside = inside(*prev);
+        
+        for (const auto& point : input) {
+            bool pointInside = inside(point);
+            if (pointInside) {
+                if (!prevInside) {
+                    output.push_back(intersect(*prev, point));
+                }
+                output.push_back(point);
+            } else if (prevInside) {
+                output.push_back(intersect(*prev, point));
+            }
+            prev = &point;
+            prevInside = pointInside;
+        }
+        
+        std::swap(input, output);
+    }
+    
+    if (input.size() < 3) {
+        return;
+    }
+    
+    _out = std::move(input);
+    
+    if (closed) {
+        _out.push_back(_out.front());
+    }
+    
+}
+
+void Clipping::simplify(Line& _line, float _tolerance) {
+    
+    if (_line.size() < 3) {
+        return;
+    }
+    
+    float sqTolerance = _tolerance * _tolerance;
+    
+    std::vector<bool> keep(_line.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+    
+    // Douglas-Peucker, iterating over a stack of ranges instead of recursing
+    std::vector<std::pair<size_t, size_t>> ranges;
+    ranges.emplace_back(0, _line.size() - 1);
+    
+    while (!ranges.empty()) {
+        
+        size_t first = ranges.back().first;
+        size_t last = ranges.back().second;
+        ranges.pop_back();
+        
+        const Point& a = _line[first];
+        const Point& b = _line[last];
+        float dx = b.x - a.x;
+        float dy = b.y - a.y;
+        float sqLength = dx * dx + dy * dy;
+        
+        float maxSqDist = 0.f;
+        size_t index = first;
+        
+        for (size_t i = first + 1; i < last; i++) {
+            const Point& p = _line[i];
+            float px = p.x - a.x;
+            float py = p.y - a.y;
+            float sqDist;
+            if (sqLength > 0.f) {
+                // squared distance to the segment a-b
+                float t = std::min(1.f, std::max(0.f, (px * dx + py * dy) / sqLength));
+                float ex = px - t * dx;
+                float ey = py - t * dy;
+                sqDist = ex * ex + ey * ey;
+            } else {
+                // closed ring, a and b coincide
+                sqDist = px * px + py * py;
+            }
+            if (sqDist > maxSqDist) {
+                maxSqDist = sqDist;
+                index = i;
+            }
+        }
+        
+        if (maxSqDist > sqTolerance) {
+            keep[index] = true;
+            ranges.emplace_back(first, index);
+            ranges.emplace_back(index, last);
+        }
+    }
+    
+    size_t count = 0;
+    for (size_t i = 0; i < _line.size(); i++) {
+        if (keep[i]) {
+            _line[count++] = _line[i];
+        }
+    }
+    _line.resize(count);
+    
+}
+
+bool Clipping::isDegenerateRing(const Line& _ring) {
+    
+    if (_ring.size() < 3) {
+        return true;
+    }
+    
+    // Look for a third point distinct from the first two distinct ones
+    const Point& first = _ring[0];
+    const Point* second = nullptr;
+    
+    for (size_t i = 1; i < _ring.size(); i++) {
+        const Point& p = _ring[i];
+        if (p == first) {
+            continue;
+        }
+        if (!second) {
+            second = &p;
+        } else if (p != *second) {
+            return false;
+        }
+    }
+    
+    return true;
+    
+}
+
+void Clipping::processTileData(TileData& _data, float _buffer, float _tolerance) {
+    
+    bool clip = _buffer >= 0.f;
+    bool simplifying = _tolerance > 0.f;
+    
+    if (!clip && !simplifying) {
+        return;
+    }
+    
+    float max = 1.f + _buffer;
+    float min = -max;
+    
+    std::vector<Line> lines;
+    Line ring;
+    
+    for (auto& layer : _data.layers) {
+        for (auto& feature : layer.features) {
+            
+            switch (feature.geometryType) {
+                case GeometryType::POINTS:
+                    if (clip) {
+                        auto outside = [&](const Point& _p) {
+                            return _p.x < min || _p.x > max || _p.y < min || _p.y > max;
+                        };
+                        feature.points.erase(std::remove_if(feature.points.begin(), feature.points.end(), outside), feature.points.end());
+                    }
+                    break;
+                case GeometryType::LINES:
+                    if (clip) {
+                        lines.clear();
+                        for (const auto& line : feature.lines) {
+                            clipLine(line, min, max, lines);
+                        }
+                        std::swap(lines, feature.lines);
+                    }
+                    if (simplifying) {
+                        for (auto& line : feature.lines) {
+                            simplify(line, _tolerance);
+                        }
+                    }
+                    break;
+                case GeometryType::POLYGONS:
+                {
+                    auto polygon = feature.polygons.begin();
+                    while (polygon != feature.polygons.end()) {
+                        for (auto& contour : *polygon) {
+                            if (clip) {
+                                clipRing(contour, min, max, ring);
+                                std::swap(ring, contour);
+                            }
+                            if (simplifying) {
+                                simplify(contour, _tolerance);
+                            }
+                        }
+                        // Remove contours that were clipped or simplified away; if the outer contour is gone, so is the polygon
+                        if (polygon->empty() || isDegenerateRing(polygon->front())) {
+                            polygon = feature.polygons.erase(polygon);
+                            continue;
+                        }
+                        polygon->erase(std::remove_if(polygon->begin(), polygon->end(), isDegenerateRing), polygon->end());
+                        ++polygon;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+    
+}
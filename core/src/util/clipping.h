@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+
+#include "tileData.h"
+
+/* Client-side processing of tile geometry: clipping to the extent of a tile (plus a buffer)
+ * and simplification of lines and polygon rings. All functions work in tile coordinates */
+namespace Clipping {
+    
+    /* Clips a line against the square [_min, _max] in x and y using the Liang-Barsky algorithm;
+     * since a line may leave and re-enter the square, the visible parts are appended to _out
+     * as separate lines */
+    void clipLine(const Line& _line, float _min, float _max, std::vector<Line>& _out);
+    
+    /* Clips a polygon ring against the square [_min, _max] in x and y using the Sutherland-Hodgman
+     * algorithm; the result is written to _out, closed if _ring was closed */
+    void clipRing(const Line& _ring, float _min, float _max, Line& _out);
+    
+    /* Simplifies a line or ring in place with the Douglas-Peucker algorithm, removing points 
+     * closer than _tolerance to the simplified shape; end points are always kept */
+    void simplify(Line& _line, float _tolerance);
+    
+    /* Returns true if _ring has fewer than 3 distinct points, e.g. a closed ring [a, b, a] left by simplification */
+    bool isDegenerateRing(const Line& _ring);
+    
+    /* Clips (if _buffer >= 0) and simplifies (if _tolerance > 0) all geometry of _data, 
+     * dropping points, lines and polygons left entirely outside of the tile plus _buffer */
+    void processTileData(TileData& _data, float _buffer, float _tolerance);
+    
+}
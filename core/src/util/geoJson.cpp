@@ -12,11 +12,17 @@ void GeoJson::extractPoint(const rapidjson::Value& _in, Point& _out, const MapTi
 
 void GeoJson::extractLine(const rapidjson::Value& _in, Line& _out, const MapTile& _tile) {
     
+    std::vector<glm::dvec2> lonLats;
+    lonLats.reserve(_in.Size());
+    
     for (auto itr = _in.Begin(); itr != _in.End(); ++itr) {
-        _out.emplace_back();
-        extractPoint(*itr, _out.back(), _tile);
+        lonLats.emplace_back((*itr)[0].GetDouble(), (*itr)[1].GetDouble());
     }
     
+    size_t offset = _out.size();
+    _out.resize(offset + lonLats.size());
+    _tile.getProjection()->LonLatToTileCoords(lonLats.data(), lonLats.size(), _tile.getOrigin(), _tile.getInverseScale(), _out.data() + offset);
+    
 }
 
 void GeoJson::extractPoly(const rapidjson::Value& _in, Polygon& _out, const MapTile& _tile) {
@@ -28,38 +34,42 @@ void GeoJson::extractPoly(const rapidjson::Value& _in, Polygon& _out, const MapT
     
 }
 
-void GeoJson::extractFeature(const rapidjson::Value& _in, Feature& _out, const MapTile& _tile) {
-    
-    // Copy properties into tile data
-    
-    const rapidjson::Value& properties = _in["properties"];
+void GeoJson::extractProperties(const rapidjson::Value& _in, Properties& _out, const MapTile& _tile) {
     
-    for (auto itr = properties.MemberBegin(); itr != properties.MemberEnd(); ++itr) {
+    for (auto itr = _in.MemberBegin(); itr != _in.MemberEnd(); ++itr) {
         
         const auto& member = itr->name.GetString();
         
-        const rapidjson::Value& prop = properties[member];
+        const rapidjson::Value& prop = itr->value;
         
         // height and minheight need to be handled separately so that their dimensions are normalized
         if (strcmp(member, "height") == 0) {
-            _out.props.numericProps[member] = prop.GetDouble() * _tile.getInverseScale();
+            _out.numericProps[member] = prop.GetDouble() * _tile.getInverseScale();
             continue;
         }
         
         if (strcmp(member, "min_height") == 0) {
-            _out.props.numericProps[member] = prop.GetDouble() * _tile.getInverseScale();
+            _out.numericProps[member] = prop.GetDouble() * _tile.getInverseScale();
             continue;
         }
         
         
         if (prop.IsNumber()) {
-            _out.props.numericProps[member] = prop.GetDouble();
+            _out.numericProps[member] = prop.GetDouble();
         } else if (prop.IsString()) {
-            _out.props.stringProps[member] = prop.GetString();
+            _out.stringProps[member] = prop.GetString();
         }
         
     }
     
+}
+
+void GeoJson::extractFeature(const rapidjson::Value& _in, Feature& _out, const MapTile& _tile) {
+    
+    // Copy properties into tile data
+    
+    extractProperties(_in["properties"], _out.props, _tile);
+    
     // Copy geometry into tile data
     
     const rapidjson::Value& geometry = _in["geometry"];
@@ -126,3 +136,285 @@ void GeoJson::extractLayer(const rapidjson::Value& _in, Layer& _out, const MapTi
     }
     
 }
+
+GeoJson::TileHandler::TileHandler(TileData& _out, const MapTile& _tile) : m_tileData(_out), m_tile(_tile) {
+}
+
+bool GeoJson::TileHandler::scalar() {
+    
+    // Nulls and booleans carry nothing that is kept in tile data
+    return true;
+    
+}
+
+bool GeoJson::TileHandler::number(double _value) {
+    
+    if (m_skipDepth > 0) {
+        return true;
+    }
+    
+    switch (m_state) {
+        case State::PROPERTIES:
+            // height and minheight need to be handled separately so that their dimensions are normalized
+            if (m_key == "height" || m_key == "min_height") {
+                _value *= m_tile.getInverseScale();
+            }
+            m_feature->props.numericProps[m_key] = _value;
+            break;
+        case State::COORDINATES:
+            // Only longitude and latitude are used, any altitude is dropped
+            if (m_numbers < 2) {
+                m_position[m_numbers] = _value;
+            }
+            m_numbers++;
+            break;
+        default:
+            break;
+    }
+    
+    return true;
+    
+}
+
+bool GeoJson::TileHandler::String(const char* _str, rapidjson::SizeType _length, bool _copy) {
+    
+    if (m_skipDepth > 0) {
+        return true;
+    }
+    
+    if (m_state == State::PROPERTIES) {
+        m_feature->props.stringProps[m_key].assign(_str, _length);
+    } else if (m_state == State::GEOMETRY && m_key == "type") {
+        m_geometryType.assign(_str, _length);
+    }
+    
+    return true;
+    
+}
+
+bool GeoJson::TileHandler::Key(const char* _str, rapidjson::SizeType _length, bool _copy) {
+    
+    if (m_skipDepth == 0) {
+        m_key.assign(_str, _length);
+    }
+    
+    return true;
+    
+}
+
+bool GeoJson::TileHandler::StartObject() {
+    
+    if (m_skipDepth > 0) {
+        m_skipDepth++;
+        return true;
+    }
+    
+    switch (m_state) {
+        case State::DOCUMENT:
+            m_state = State::ROOT;
+            break;
+        case State::ROOT:
+            m_tileData.layers.emplace_back(m_key);
+            m_state = State::LAYER;
+            break;
+        case State::FEATURES:
+            m_tileData.layers.back().features.emplace_back();
+            m_feature = &m_tileData.layers.back().features.back();
+            m_geometryType.clear();
+            m_positions.clear();
+            m_lineEnds.clear();
+            m_polygonEnds.clear();
+            m_positionDepth = 0;
+            m_state = State::FEATURE;
+            break;
+        case State::FEATURE:
+            if (m_key == "properties") {
+                m_state = State::PROPERTIES;
+            } else if (m_key == "geometry") {
+                m_state = State::GEOMETRY;
+            } else {
+                m_skipDepth = 1;
+            }
+            break;
+        default:
+            m_skipDepth = 1;
+            break;
+    }
+    
+    return true;
+    
+}
+
+bool GeoJson::TileHandler::EndObject(rapidjson::SizeType _memberCount) {
+    
+    if (m_skipDepth > 0) {
+        m_skipDepth--;
+        return true;
+    }
+    
+    switch (m_state) {
+        case State::ROOT:
+            m_state = State::DOCUMENT;
+            break;
+        case State::LAYER:
+            m_state = State::ROOT;
+            break;
+        case State::FEATURE:
+            buildGeometry();
+            m_feature = nullptr;
+            m_state = State::FEATURES;
+            break;
+        case State::PROPERTIES:
+        case State::GEOMETRY:
+            m_state = State::FEATURE;
+            break;
+        default:
+            break;
+    }
+    
+    return true;
+    
+}
+
+bool GeoJson::TileHandler::StartArray() {
+    
+    if (m_skipDepth > 0) {
+        m_skipDepth++;
+        return true;
+    }
+    
+    switch (m_state) {
+        case State::LAYER:
+            if (m_key == "features") {
+                m_state = State::FEATURES;
+            } else {
+                m_skipDepth = 1;
+            }
+            break;
+        case State::GEOMETRY:
+            if (m_key == "coordinates") {
+                m_coordDepth = 1;
+                m_numbers = 0;
+                m_state = State::COORDINATES;
+            } else {
+                m_skipDepth = 1;
+            }
+            break;
+        case State::COORDINATES:
+            m_coordDepth++;
+            m_numbers = 0;
+            break;
+        default:
+            m_skipDepth = 1;
+            break;
+    }
+    
+    return true;
+    
+}
+
+bool GeoJson::TileHandler::EndArray(rapidjson::SizeType _elementCount) {
+    
+    if (m_skipDepth > 0) {
+        m_skipDepth--;
+        return true;
+    }
+    
+    switch (m_state) {
+        case State::FEATURES:
+            m_state = State::LAYER;
+            break;
+        case State::COORDINATES:
+            // An array of numbers is a position; arrays one and two levels above the positions
+            // close a line (or ring) and a polygon respectively
+            if (m_numbers > 0) {
+                if (m_numbers >= 2) {
+                    m_positions.push_back(m_position);
+                }
+                m_positionDepth = m_coordDepth;
+                m_numbers = 0;
+            } else if (m_coordDepth == m_positionDepth - 1) {
+                m_lineEnds.push_back(m_positions.size());
+            } else if (m_coordDepth == m_positionDepth - 2) {
+                m_polygonEnds.push_back(m_lineEnds.size());
+            }
+            if (--m_coordDepth == 0) {
+                m_state = State::GEOMETRY;
+            }
+            break;
+        default:
+            break;
+    }
+    
+    return true;
+    
+}
+
+void GeoJson::TileHandler::buildGeometry() {
+    
+    Feature& feature = *m_feature;
+    
+    // All positions of the feature are projected in one batch
+    m_points.resize(m_positions.size());
+    m_tile.getProjection()->LonLatToTileCoords(m_positions.data(), m_positions.size(), m_tile.getOrigin(), m_tile.getInverseScale(), m_points.data());
+    
+    auto appendPoints = [&](std::vector<Point>& _points, size_t _begin, size_t _end) {
+        _points.insert(_points.end(), m_points.begin() + _begin, m_points.begin() + _end);
+    };
+    
+    auto appendRings = [&](Polygon& _polygon, size_t _beginLine, size_t _endLine) {
+        _polygon.reserve(_endLine - _beginLine);
+        size_t begin = _beginLine > 0 ? m_lineEnds[_beginLine - 1] : 0;
+        for (size_t i = _beginLine; i < _endLine; i++) {
+            _polygon.emplace_back();
+            appendPoints(_polygon.back(), begin, m_lineEnds[i]);
+            begin = m_lineEnds[i];
+        }
+    };
+    
+    if (m_geometryType == "Point" || m_geometryType == "MultiPoint") {
+        
+        feature.geometryType = GeometryType::POINTS;
+        appendPoints(feature.points, 0, m_positions.size());
+        
+    } else if (m_geometryType == "LineString") {
+        
+        feature.geometryType = GeometryType::LINES;
+        feature.lines.emplace_back();
+        appendPoints(feature.lines.back(), 0, m_positions.size());
+        
+    } else if (m_geometryType == "MultiLineString") {
+        
+        feature.geometryType = GeometryType::LINES;
+        feature.lines.reserve(m_lineEnds.size());
+        size_t begin = 0;
+        for (size_t end : m_lineEnds) {
+            feature.lines.emplace_back();
+            appendPoints(feature.lines.back(), begin, end);
+            begin = end;
+        }
+        
+    } else if (m_geometryType == "Polygon") {
+        
+        feature.geometryType = GeometryType::POLYGONS;
+        feature.polygons.emplace_back();
+        appendRings(feature.polygons.back(), 0, m_lineEnds.size());
+        
+    } else if (m_geometryType == "MultiPolygon") {
+        
+        feature.geometryType = GeometryType::POLYGONS;
+        feature.polygons.reserve(m_polygonEnds.size());
+        size_t begin = 0;
+        for (size_t end : m_polygonEnds) {
+            feature.polygons.emplace_back();
+            appendRings(feature.polygons.back(), begin, end);
+            begin = end;
+        }
+        
+    } else {
+        
+        feature.geometryType = GeometryType::UNKNOWN;
+        
+    }
+    
+}
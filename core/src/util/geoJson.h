@@ -1,8 +1,10 @@
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "rapidjson/document.h"
+#include "rapidjson/reader.h"
 
 #include "mapTile.h"
 #include "tileData.h"
@@ -15,10 +17,67 @@ namespace GeoJson {
     
     void extractPoly(const rapidjson::Value& _in, Polygon& _out, const MapTile& _tile);
     
+    void extractProperties(const rapidjson::Value& _in, Properties& _out, const MapTile& _tile);
+    
     void extractFeature(const rapidjson::Value& _in, Feature& _out, const MapTile& _tile);
     
     void extractLayer(const rapidjson::Value& _in, Layer& _out, const MapTile& _tile);
     
+    /* SAX handler for rapidjson::Reader that builds a TileData in a single pass over a GeoJSON tile, 
+     * without creating an intermediate document. Each top-level member of the tile is read as a layer 
+     * (a FeatureCollection); members the handler doesn't need are skipped over */
+    class TileHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, TileHandler> {
+        
+    public:
+        
+        TileHandler(TileData& _out, const MapTile& _tile);
+        
+        bool Null() { return scalar(); }
+        bool Bool(bool) { return scalar(); }
+        bool Int(int _i) { return number(_i); }
+        bool Uint(unsigned _u) { return number(_u); }
+        bool Int64(int64_t _i) { return number(_i); }
+        bool Uint64(uint64_t _u) { return number(_u); }
+        bool Double(double _d) { return number(_d); }
+        bool String(const char* _str, rapidjson::SizeType _length, bool _copy);
+        bool Key(const char* _str, rapidjson::SizeType _length, bool _copy);
+        bool StartObject();
+        bool EndObject(rapidjson::SizeType _memberCount);
+        bool StartArray();
+        bool EndArray(rapidjson::SizeType _elementCount);
+        
+    private:
+        
+        enum class State { DOCUMENT, ROOT, LAYER, FEATURES, FEATURE, PROPERTIES, GEOMETRY, COORDINATES };
+        
+        bool scalar();
+        bool number(double _value);
+        
+        /* Builds the geometry of the current feature from the buffered coordinates */
+        void buildGeometry();
+        
+        TileData& m_tileData;
+        const MapTile& m_tile;
+        
+        State m_state = State::DOCUMENT;
+        int m_skipDepth = 0; // nesting depth of an unused value being skipped, 0 when not skipping
+        std::string m_key; // most recently read member name
+        
+        Feature* m_feature = nullptr;
+        std::string m_geometryType;
+        
+        // Coordinates are buffered until the end of the feature since the geometry type may come after them
+        std::vector<glm::dvec2> m_positions;
+        std::vector<Point> m_points; // m_positions projected into tile coordinates
+        std::vector<size_t> m_lineEnds; // end index into m_positions of each line or ring
+        std::vector<size_t> m_polygonEnds; // end index into m_lineEnds of each polygon
+        glm::dvec2 m_position;
+        int m_positionDepth = 0; // nesting depth of the position arrays in the current coordinates
+        int m_coordDepth = 0; // nesting depth inside the current coordinates
+        int m_numbers = 0; // count of numbers in the current array of the coordinates
+        
+    };
+    
 }
 
 
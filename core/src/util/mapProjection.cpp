@@ -8,6 +8,13 @@
 
 #include "mapProjection.h"
 
+void MapProjection::LonLatToTileCoords(const glm::dvec2* _lonLat, size_t _count, const glm::dvec2& _origin, double _invScale, glm::vec3* _out) const {
+    for (size_t i = 0; i < _count; i++) {
+        glm::dvec2 meters = LonLatToMeters(_lonLat[i]);
+        _out[i] = glm::vec3((meters.x - _origin.x) * _invScale, (meters.y - _origin.y) * _invScale, 0.0);
+    }
+}
+
 MercatorProjection::MercatorProjection(int _tileSize) : MapProjection(ProjectionType::mercator), m_TileSize(_tileSize) {
     double invTileSize = 1.0/m_TileSize;
     m_Res = 2.0 * HALF_CIRCUMFERENCE * invTileSize;
@@ -21,6 +28,22 @@ glm::dvec2 MercatorProjection::LonLatToMeters(const glm::dvec2 _lonLat) const {
     return (meters);
 }
 
+void MercatorProjection::LonLatToTileCoords(const glm::dvec2* _lonLat, size_t _count, const glm::dvec2& _origin, double _invScale, glm::vec3* _out) const {
+    // Projection, origin offset and tile scale are folded into one multiply-add per axis
+    const double scaleX = HALF_CIRCUMFERENCE * INV_180 * _invScale;
+    const double scaleY = R_EARTH * _invScale;
+    const double offsetX = -_origin.x * _invScale;
+    const double offsetY = -_origin.y * _invScale;
+    const double degToRad = PI * INV_180;
+    // Scalar loop with the per-position work reduced to one sin and one log;
+    // log(tan(pi/4 + lat/2)) is computed as its equivalent atanh(sin(lat)) = 0.5 * log((1 + sin(lat)) / (1 - sin(lat)))
+    for (size_t i = 0; i < _count; i++) {
+        double sinLat = sin(_lonLat[i].y * degToRad);
+        double y = 0.5 * log((1.0 + sinLat) / (1.0 - sinLat));
+        _out[i] = glm::vec3(_lonLat[i].x * scaleX + offsetX, y * scaleY + offsetY, 0.0);
+    }
+}
+
 glm::dvec2 MercatorProjection::MetersToLonLat(const glm::dvec2 _meters) const {
     glm::dvec2 lonLat;
     double invHalfCircum = 1.0/HALF_CIRCUMFERENCE;
@@ -3,7 +3,10 @@
 //Define global constants
 #define R_EARTH 6378137.0
 
+#include <cstddef>
+
 #include "glm/vec2.hpp"
+#include "glm/vec3.hpp"
 #include "glm/vec4.hpp"
 #include "tileID.h"
 #include "geom.h"
@@ -35,6 +38,17 @@ public:
      */
     virtual glm::dvec2 LonLatToMeters(const glm::dvec2 _lonLat) const = 0;
 
+    /*
+     * Batch of LonLat to tile coordinates, relative to a tile origin and scale
+     * Arguments:
+     *   _lonLat: array of _count glm::dvec2 having lon and lat info
+     *   _count: number of positions to project
+     *   _origin: origin of the tile in projection-meters
+     *   _invScale: inverse scale of the tile, from projection-meters to tile units
+     *   _out: array receiving the _count tile coordinates (glm::vec3, z set to 0)
+     */
+    virtual void LonLatToTileCoords(const glm::dvec2* _lonLat, size_t _count, const glm::dvec2& _origin, double _invScale, glm::vec3* _out) const;
+
     /* 
      * ProjectionType-Meters to Lon Lat
      *  Arguments: 
@@ -140,6 +154,7 @@ public:
     MercatorProjection(int  _tileSize=256);
 
     virtual glm::dvec2 LonLatToMeters(const glm::dvec2 _lonLat) const override;
+    virtual void LonLatToTileCoords(const glm::dvec2* _lonLat, size_t _count, const glm::dvec2& _origin, double _invScale, glm::vec3* _out) const override;
     virtual glm::dvec2 MetersToLonLat(const glm::dvec2 _meters) const override;
     virtual glm::dvec2 PixelsToMeters(const glm::dvec2 _pix, const int _zoom) const override;
     virtual glm::dvec2 MetersToPixel(const glm::dvec2 _meters, const int _zoom) const override;
@@ -4,67 +4,88 @@
 #include <cmath>
 
 
-void PbfParser::extractGeometry(protobuf::message& _geomIn, int _tileExtent, std::vector<Line>& _out, const MapTile& _tile) {
+// Zigzag-decodes a run of command parameters; the loop body has no branches and no
+// dependencies between iterations, so the compiler can vectorize it
+static void zigzagDecode(const uint32_t* _in, int32_t* _out, size_t _count) {
     
-    pbfGeomCmd cmd = pbfGeomCmd::moveTo;
-    uint32_t cmdRepeat = 0;
+    for (size_t i = 0; i < _count; i++) {
+        _out[i] = static_cast<int32_t>((_in[i] >> 1) ^ (~(_in[i] & 1) + 1));
+    }
+    
+}
+
+void PbfParser::decodeGeometry(protobuf::message& _geomIn, GeometryBuffer& _buffer) {
+    
+    _buffer.coords.clear();
+    _buffer.lineSizes.clear();
     
-    double invTileExtent = (1.0/(double)_tileExtent);
+    int32_t x = 0;
+    int32_t y = 0;
     
-    Line line;
+    size_t lineStart = 0; // index of the first coordinate of the current line
     
-    int64_t x = 0;
-    int64_t y = 0;
+    auto endLine = [&]() {
+        size_t lineSize = _buffer.coords.size() - lineStart;
+        if (lineSize > 0) {
+            _buffer.lineSizes.push_back(lineSize);
+            lineStart = _buffer.coords.size();
+        }
+    };
     
     while(_geomIn.getData() < _geomIn.getEnd()) {
         
-        if(cmdRepeat == 0) { // get new command, lengh and parameters..
-            uint32_t cmdData = static_cast<uint32_t>(_geomIn.varint());
-            cmd = static_cast<pbfGeomCmd>(cmdData & 0x7); //first 3 bits of the cmdData
-            cmdRepeat = cmdData >> 3; //last 5 bits
-        }
+        uint32_t cmdData = static_cast<uint32_t>(_geomIn.varint());
+        pbfGeomCmd cmd = static_cast<pbfGeomCmd>(cmdData & 0x7); //first 3 bits of the cmdData
+        uint32_t cmdRepeat = cmdData >> 3; //last 5 bits
         
-        if(cmd == pbfGeomCmd::moveTo || cmd == pbfGeomCmd::lineTo) { // get parameters/points
-            // if cmd is move then move to a new line/set of points and save this line
-            if(cmd == pbfGeomCmd::moveTo) {
-                if(line.size() > 0) {
-                    _out.push_back(line);
-                }
-                line.clear();
+        if(cmd == pbfGeomCmd::moveTo || cmd == pbfGeomCmd::lineTo) {
+            
+            // the command header gives the number of points in this run, so all of its
+            // parameters are read and decoded in one batch
+            size_t nParams = 2 * cmdRepeat;
+            _buffer.params.resize(nParams);
+            _buffer.deltas.resize(nParams);
+            
+            for (size_t i = 0; i < nParams; i++) {
+                _buffer.params[i] = static_cast<uint32_t>(_geomIn.varint2());
             }
             
-            x += _geomIn.svarint();
-            y += _geomIn.svarint();
+            zigzagDecode(_buffer.params.data(), _buffer.deltas.data(), nParams);
             
-            // bring the points in -1 to 1 space
-            Point p;
-            p.x = invTileExtent * (double)(2 * x - _tileExtent);
-            p.y = invTileExtent * (double)(_tileExtent - 2 * y);
+            _buffer.coords.reserve(_buffer.coords.size() + cmdRepeat + 1); // room for a closing point
             
-            line.push_back(p);
+            for (uint32_t i = 0; i < cmdRepeat; i++) {
+                // every moveTo begins a new line/set of points
+                if (cmd == pbfGeomCmd::moveTo) {
+                    endLine();
+                }
+                x += _buffer.deltas[2 * i];
+                y += _buffer.deltas[2 * i + 1];
+                _buffer.coords.emplace_back(x, y);
+            }
             
-        } else if( cmd == pbfGeomCmd::closePath) { // end of a polygon, push first point in this line as last and push line to poly
-            line.push_back(line[0]);
-            _out.push_back(line);
-            line.clear();
+        } else if(cmd == pbfGeomCmd::closePath) { // end of a polygon ring, repeat its first point as last
+            if (_buffer.coords.size() > lineStart) {
+                glm::ivec2 first = _buffer.coords[lineStart];
+                _buffer.coords.push_back(first);
+            }
+            endLine();
         }
-        
-        cmdRepeat--;
     }
     
     // Enter the last line
-    if(line.size() > 0) {
-        _out.push_back(line);
-    }
+    endLine();
     
 }
 
-void PbfParser::extractFeature(protobuf::message& _featureIn, Feature& _out, const MapTile& _tile, std::vector<std::string>& _keys, std::vector<float>& _numericValues, std::vector<std::string>& _stringValues, int _tileExtent) {
+void PbfParser::extractFeature(protobuf::message& _featureIn, Feature& _out, const MapTile& _tile, std::vector<std::string>& _keys, std::vector<float>& _numericValues, std::vector<std::string>& _stringValues, int _tileExtent, GeometryBuffer& _geomBuffer) {
 
     //Iterate through this feature
-    std::vector<Line> geometryLines;
     protobuf::message geometry; // By default data_ and end_ are nullptr
     
+    _geomBuffer.coords.clear();
+    _geomBuffer.lineSizes.clear();
+    
     while(_featureIn.next()) {
         switch(_featureIn.tag) {
             // Feature ID
@@ -125,7 +146,7 @@ void PbfParser::extractFeature(protobuf::message& _featureIn, Feature& _out, con
             // Actual geometry data
             case 4:
                 geometry = _featureIn.getMessage();
-                extractGeometry(geometry, _tileExtent, geometryLines, _tile);
+                decodeGeometry(geometry, _geomBuffer);
                 break;
             // None.. skip
             default:
@@ -134,22 +155,43 @@ void PbfParser::extractFeature(protobuf::message& _featureIn, Feature& _out, con
         }
     }
     
+    // Integer coordinates are brought into the [-1, 1] range of tile space with a single
+    // multiply-add each, written straight into containers reserved to their exact sizes
+    const float scale = 2.f / _tileExtent;
+    const glm::ivec2* coord = _geomBuffer.coords.data();
+    const auto& lineSizes = _geomBuffer.lineSizes;
+    
+    auto appendPoints = [&](std::vector<Point>& _points, size_t _count) {
+        for (size_t i = 0; i < _count; i++, coord++) {
+            _points.emplace_back(coord->x * scale - 1.f, 1.f - coord->y * scale, 0.f);
+        }
+    };
+    
     switch(_out.geometryType) {
         case GeometryType::POINTS:
-            for(auto& line : geometryLines) {
-                for(auto& point : line) {
-                    _out.points.emplace_back(point);
-                }
-            }
+            _out.points.reserve(_geomBuffer.coords.size());
+            appendPoints(_out.points, _geomBuffer.coords.size());
             break;
         case GeometryType::LINES:
-            for(auto& line : geometryLines) {
-                _out.lines.emplace_back(line);
+            _out.lines.reserve(lineSizes.size());
+            for(auto lineSize : lineSizes) {
+                _out.lines.emplace_back();
+                _out.lines.back().reserve(lineSize);
+                appendPoints(_out.lines.back(), lineSize);
             }
             break;
         case GeometryType::POLYGONS:
-            _out.polygons.emplace_back(geometryLines);
+        {
+            _out.polygons.emplace_back();
+            Polygon& polygon = _out.polygons.back();
+            polygon.reserve(lineSizes.size());
+            for(auto lineSize : lineSizes) {
+                polygon.emplace_back();
+                polygon.back().reserve(lineSize);
+                appendPoints(polygon.back(), lineSize);
+            }
             break;
+        }
         case GeometryType::UNKNOWN:
             break;
         default:
@@ -164,6 +206,7 @@ void PbfParser::extractLayer(protobuf::message& _layerIn, Layer& _out, const Map
     std::vector<float> numericValues;
     std::vector<std::string> stringValues;
     std::vector<protobuf::message> featureMsgs;
+    GeometryBuffer geomBuffer;
     int tileExtent = 0;
     
     //iterate layer to populate featureMsgs, keys and values
@@ -236,8 +279,10 @@ void PbfParser::extractLayer(protobuf::message& _layerIn, Layer& _out, const Map
         }
     }
     
+    _out.features.reserve(featureMsgs.size());
+    
     for(auto& featureMsg : featureMsgs) {
         _out.features.emplace_back();
-        extractFeature(featureMsg, _out.features.back(), _tile, keys, numericValues, stringValues, tileExtent);
+        extractFeature(featureMsg, _out.features.back(), _tile, keys, numericValues, stringValues, tileExtent, geomBuffer);
     }
 }
@@ -5,15 +5,30 @@
 #include <string>
 
 #include "pbf/pbf.hpp"
+#include "glm/vec2.hpp"
 
 #include "mapTile.h"
 #include "tileData.h"
 
 namespace PbfParser {
     
-    void extractGeometry(protobuf::message& _geomIn, int _tileExtent, std::vector<Line>& _out, const MapTile& _tile);
+    /* Scratch buffers for geometry decoding, reused across all features of a layer */
+    struct GeometryBuffer {
+        std::vector<uint32_t> params; // zigzag-encoded parameters of the current command run
+        std::vector<int32_t> deltas; // decoded parameters of the current command run
+        std::vector<glm::ivec2> coords; // absolute integer tile coordinates of the geometry
+        std::vector<uint32_t> lineSizes; // number of coordinates in each line (or ring) of the geometry
+    };
+    
+    /* Decodes a geometry command stream into integer tile coordinates
+     *
+     * Each command run is read in one batch and zigzag-decoded in a single loop; the
+     * coordinates of all lines are stored contiguously in @_buffer, with the size of
+     * each line recorded so that output containers can be reserved exactly
+     */
+    void decodeGeometry(protobuf::message& _geomIn, GeometryBuffer& _buffer);
     
-    void extractFeature(protobuf::message& _featureIn, Feature& _out, const MapTile& _tile, std::vector<std::string>& _keys, std::vector<float>& _numericValues, std::vector<std::string>& _stringValues, int _tileExtent);
+    void extractFeature(protobuf::message& _featureIn, Feature& _out, const MapTile& _tile, std::vector<std::string>& _keys, std::vector<float>& _numericValues, std::vector<std::string>& _stringValues, int _tileExtent, GeometryBuffer& _geomBuffer);
     
     void extractLayer(protobuf::message& _in, Layer& _out, const MapTile& _tile);
     
@@ -1,8 +1,41 @@
 #include "shaderProgram.h"
 #include "scene/light.h"
 
+#include <cstring>
+
 GLuint ShaderProgram::s_activeGlProgram = 0;
 int ShaderProgram::s_validGeneration = 0;
+int ShaderProgram::s_buildCount = 0;
+
+namespace {
+
+    // Names of all uniforms by id, and their ids by name; shared by all programs
+    std::vector<std::string>& uniformNames() {
+        static std::vector<std::string> names;
+        return names;
+    }
+
+    int uniformId(const std::string& _name) {
+        static std::unordered_map<std::string, int> ids;
+
+        auto it = ids.find(_name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+
+        int id = uniformNames().size();
+        uniformNames().push_back(_name);
+        ids.emplace(_name, id);
+        return id;
+    }
+
+}
+
+UniformLocation::UniformLocation(const std::string& _name) : m_id(uniformId(_name)) {}
+
+const std::string& UniformLocation::getName() const {
+    return uniformNames()[m_id];
+}
 
 ShaderProgram::ShaderProgram() {
 
@@ -12,6 +45,7 @@ ShaderProgram::ShaderProgram() {
     m_needsBuild = true;
     m_freeTextureUnit = 0;
     m_generation = -1;
+    m_buildId = 0;
 }
 
 ShaderProgram::~ShaderProgram() {
@@ -72,16 +106,49 @@ const GLint ShaderProgram::getAttribLocation(const std::string& _attribName) {
 
 const GLint ShaderProgram::getUniformLocation(const std::string& _uniformName) {
 
-    // Get uniform location at this key, or create one valued at -2 if absent
-    GLint& location = m_uniformMap[_uniformName].loc;
+    return getUniformState(uniformId(_uniformName)).loc;
+
+}
+
+ShaderProgram::UniformState& ShaderProgram::getUniformState(int _id) {
+
+    if (_id >= (int)m_uniforms.size()) {
+        m_uniforms.resize(_id + 1);
+    }
+
+    UniformState& uniform = m_uniforms[_id];
 
     // -2 means this is a new entry
-    if (location == -2) {
+    if (uniform.loc == -2) {
         // Get the actual location from OpenGL
-        location = glGetUniformLocation(m_glProgram, _uniformName.c_str());
+        uniform.loc = glGetUniformLocation(m_glProgram, uniformNames()[_id].c_str());
     }
 
-    return location;
+    return uniform;
+
+}
+
+bool ShaderProgram::updateUniform(int _id, const void* _value, GLsizei _size, GLint& _location, bool _transposed) {
+
+    use();
+
+    UniformState& uniform = getUniformState(_id);
+    _location = uniform.loc;
+
+    if (_location < 0) {
+        // Not an active uniform of this program
+        return false;
+    }
+
+    if (uniform.size == _size && uniform.transposed == _transposed && std::memcmp(uniform.value, _value, _size) == 0) {
+        return false;
+    }
+
+    std::memcpy(uniform.value, _value, _size);
+    uniform.size = _size;
+    uniform.transposed = _transposed;
+
+    return true;
 
 }
 
@@ -152,11 +219,12 @@ bool ShaderProgram::build() {
     m_glFragmentShader = fragmentShader;
     m_glVertexShader = vertexShader;
     m_glProgram = program;
+    m_buildId = ++s_buildCount;
 
     // Clear any cached shader locations
 
     m_attribMap.clear();
-    m_uniformMap.clear();
+    m_uniforms.clear();
 
     return true;
 }
@@ -267,67 +335,112 @@ void ShaderProgram::invalidateAllPrograms() {
 }
 
 void ShaderProgram::setUniformi(const std::string& _name, int _value) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniform1i(location, _value);
+    setUniformi(UniformLocation(_name), _value);
 }
 
 void ShaderProgram::setUniformi(const std::string& _name, int _value0, int _value1) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniform2i(location, _value0, _value1);
+    GLint location;
+    int value[] = { _value0, _value1 };
+    if (updateUniform(uniformId(_name), value, sizeof(value), location)) {
+        glUniform2i(location, _value0, _value1);
+    }
 }
 
 void ShaderProgram::setUniformi(const std::string& _name, int _value0, int _value1, int _value2) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniform3i(location, _value0, _value1, _value2);
+    GLint location;
+    int value[] = { _value0, _value1, _value2 };
+    if (updateUniform(uniformId(_name), value, sizeof(value), location)) {
+        glUniform3i(location, _value0, _value1, _value2);
+    }
 }
 
 void ShaderProgram::setUniformi(const std::string& _name, int _value0, int _value1, int _value2, int _value3) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniform4i(location, _value0, _value1, _value2, _value3);
+    GLint location;
+    int value[] = { _value0, _value1, _value2, _value3 };
+    if (updateUniform(uniformId(_name), value, sizeof(value), location)) {
+        glUniform4i(location, _value0, _value1, _value2, _value3);
+    }
 }
 
 void ShaderProgram::setUniformf(const std::string& _name, float _value) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniform1f(location, _value);
+    setUniformf(UniformLocation(_name), _value);
 }
 
 void ShaderProgram::setUniformf(const std::string& _name, float _value0, float _value1) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniform2f(location, _value0, _value1);
+    setUniformf(UniformLocation(_name), _value0, _value1);
 }
 
 void ShaderProgram::setUniformf(const std::string& _name, float _value0, float _value1, float _value2) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniform3f(location, _value0, _value1, _value2);
+    setUniformf(UniformLocation(_name), _value0, _value1, _value2);
 }
 
 void ShaderProgram::setUniformf(const std::string& _name, float _value0, float _value1, float _value2, float _value3) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniform4f(location, _value0, _value1, _value2, _value3);
+    setUniformf(UniformLocation(_name), _value0, _value1, _value2, _value3);
 }
 
 void ShaderProgram::setUniformMatrix2f(const std::string& _name, const float* _value, bool _transpose) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniformMatrix2fv(location, 1, _transpose, _value);
+    GLint location;
+    if (updateUniform(uniformId(_name), _value, 4 * sizeof(float), location, _transpose)) {
+        glUniformMatrix2fv(location, 1, _transpose, _value);
+    }
 }
 
 void ShaderProgram::setUniformMatrix3f(const std::string& _name, const float* _value, bool _transpose) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniformMatrix3fv(location, 1, _transpose, _value);
+    setUniformMatrix3f(UniformLocation(_name), _value, _transpose);
 }
 
 void ShaderProgram::setUniformMatrix4f(const std::string& _name, const float* _value, bool _transpose) {
-    use();
-    GLint location = getUniformLocation(_name);
-    glUniformMatrix4fv(location, 1, _transpose, _value);
+    setUniformMatrix4f(UniformLocation(_name), _value, _transpose);
+}
+
+void ShaderProgram::setUniformi(const UniformLocation& _uniform, int _value) {
+    GLint location;
+    if (updateUniform(_uniform.m_id, &_value, sizeof(_value), location)) {
+        glUniform1i(location, _value);
+    }
+}
+
+void ShaderProgram::setUniformf(const UniformLocation& _uniform, float _value) {
+    GLint location;
+    if (updateUniform(_uniform.m_id, &_value, sizeof(_value), location)) {
+        glUniform1f(location, _value);
+    }
+}
+
+void ShaderProgram::setUniformf(const UniformLocation& _uniform, float _value0, float _value1) {
+    GLint location;
+    float value[] = { _value0, _value1 };
+    if (updateUniform(_uniform.m_id, value, sizeof(value), location)) {
+        glUniform2f(location, _value0, _value1);
+    }
+}
+
+void ShaderProgram::setUniformf(const UniformLocation& _uniform, float _value0, float _value1, float _value2) {
+    GLint location;
+    float value[] = { _value0, _value1, _value2 };
+    if (updateUniform(_uniform.m_id, value, sizeof(value), location)) {
+        glUniform3f(location, _value0, _value1, _value2);
+    }
+}
+
+void ShaderProgram::setUniformf(const UniformLocation& _uniform, float _value0, float _value1, float _value2, float _value3) {
+    GLint location;
+    float value[] = { _value0, _value1, _value2, _value3 };
+    if (updateUniform(_uniform.m_id, value, sizeof(value), location)) {
+        glUniform4f(location, _value0, _value1, _value2, _value3);
+    }
+}
+
+void ShaderProgram::setUniformMatrix3f(const UniformLocation& _uniform, const float* _value, bool _transpose) {
+    GLint location;
+    if (updateUniform(_uniform.m_id, _value, 9 * sizeof(float), location, _transpose)) {
+        glUniformMatrix3fv(location, 1, _transpose, _value);
+    }
+}
+
+void ShaderProgram::setUniformMatrix4f(const UniformLocation& _uniform, const float* _value, bool _transpose) {
+    GLint location;
+    if (updateUniform(_uniform.m_id, _value, 16 * sizeof(float), location, _transpose)) {
+        glUniformMatrix4fv(location, 1, _transpose, _value);
+    }
 }
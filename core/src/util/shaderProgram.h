@@ -17,6 +17,29 @@
 // the ShaderProgram class also has a static map of <string, vector<string>> pairs, that are injected in ALL program instances
 // class-level blocks are injected before instance-level blocks
 
+/*
+ * UniformLocation - Handle to a shader uniform by name, usable with any ShaderProgram
+ *
+ * The name is resolved to an id once, when the handle is constructed; each program resolves the id to
+ * its location on first use after a build. Construct handles once (e.g. as static members) and only on
+ * the GL thread.
+ */
+class UniformLocation {
+
+public:
+
+    explicit UniformLocation(const std::string& _name);
+
+    const std::string& getName() const;
+
+private:
+
+    int m_id;
+
+    friend class ShaderProgram;
+
+};
+
 /*
  * ShaderProgram - utility class representing an OpenGL shader program
  */
@@ -47,6 +70,9 @@ public:
     const GLuint getGlFragmentShader() const { return m_glFragmentShader; };
     const GLuint getGlVertexShader() const { return m_glVertexShader; };
 
+    /* Returns a number identifying the last successful build of this program, unique among all programs */
+    int getBuildId() const { return m_buildId; }
+
     /*
      * Fetches the location of a shader attribute, caching the result
      */
@@ -69,7 +95,8 @@ public:
     void use();
 
     /*
-     * Ensures the program is bound and then sets the named uniform to the given value(s)
+     * Ensures the program is bound and then sets the named uniform to the given value(s); the program keeps
+     * a copy of the values last set for each uniform and skips the GL call when they did not change
      */
     void setUniformi(const std::string& _name, int _value);
     void setUniformi(const std::string& _name, int _value0, int _value1);
@@ -93,6 +120,22 @@ public:
     void setUniformMatrix3f(const std::string& _name, const float* _value, bool transpose = false);
     void setUniformMatrix4f(const std::string& _name, const float* _value, bool transpose = false);
 
+    /*
+     * Same as the above, with the uniform given by a handle instead of a name, saving the lookup by name
+     */
+    void setUniformi(const UniformLocation& _uniform, int _value);
+    void setUniformf(const UniformLocation& _uniform, float _value);
+    void setUniformf(const UniformLocation& _uniform, float _value0, float _value1);
+    void setUniformf(const UniformLocation& _uniform, float _value0, float _value1, float _value2);
+    void setUniformf(const UniformLocation& _uniform, float _value0, float _value1, float _value2, float _value3);
+
+    void setUniformf(const UniformLocation& _uniform, const glm::vec2& _value){setUniformf(_uniform,_value.x,_value.y);}
+    void setUniformf(const UniformLocation& _uniform, const glm::vec3& _value){setUniformf(_uniform,_value.x,_value.y,_value.z);}
+    void setUniformf(const UniformLocation& _uniform, const glm::vec4& _value){setUniformf(_uniform,_value.x,_value.y,_value.z,_value.w);}
+
+    void setUniformMatrix3f(const UniformLocation& _uniform, const float* _value, bool transpose = false);
+    void setUniformMatrix4f(const UniformLocation& _uniform, const float* _value, bool transpose = false);
+
     /* Invalidates all managed ShaderPrograms
      *
      * This should be called in the event of a GL context loss; former GL shader object
@@ -114,15 +157,25 @@ private:
         // to a value that is not a valid uniform or attribute location.
     };
 
+    /* Location and last set value of a uniform, indexed by the id of its <UniformLocation> */
+    struct UniformState {
+        GLint loc = -2; // -2 until resolved, see <ShaderLocation>
+        GLsizei size = 0; // Size in bytes of the cached value, 0 if none was set since the last build
+        bool transposed = false;
+        GLfloat value[16];
+    };
+
     static GLuint s_activeGlProgram;
     static int s_validGeneration; // Incremented when GL context is invalidated
+    static int s_buildCount; // Number of successful builds of all programs
 
     int m_generation;
+    int m_buildId;
     GLuint m_glProgram;
     GLuint m_glFragmentShader;
     GLuint m_glVertexShader;
     std::unordered_map<std::string, ShaderLocation> m_attribMap;
-    std::unordered_map<std::string, ShaderLocation> m_uniformMap;
+    std::vector<UniformState> m_uniforms;
     std::string m_fragmentShaderSource;
     std::string m_vertexShaderSource;
 
@@ -136,6 +189,15 @@ private:
 
     void applySourceBlocks(std::string& _vertSrcOut, std::string& _fragSrcOut);
 
+    /* Returns the state of the uniform with the given id, resolving its location if needed */
+    UniformState& getUniformState(int _id);
+
+    /*
+     * Binds the program and stores _size bytes of _value for the uniform; returns false if the uniform is not
+     * active in the program or already has this value, so that the GL call can be skipped
+     */
+    bool updateUniform(int _id, const void* _value, GLsizei _size, GLint& _location, bool _transposed = false);
+
     std::unordered_map<std::string, Texture::TextureSlot> m_textureSlots;
     GLuint m_freeTextureUnit;
 
@@ -0,0 +1,331 @@
+#include "topoJson.h"
+#include "geoJson.h"
+#include "platform.h"
+#include "util/mapProjection.h"
+
+// Returns true if _in is an array of at least two numbers, as positions and transform vectors are
+static bool isPosition(const rapidjson::Value& _in) {
+    return _in.IsArray() && _in.Size() >= 2 && _in[0].IsNumber() && _in[1].IsNumber();
+}
+
+// Returns the array member _name of _in, or nullptr (logging an error) if it is missing or not an array
+static const rapidjson::Value* findArray(const rapidjson::Value& _in, const char* _name) {
+    
+    const auto& iter = _in.FindMember(_name);
+    
+    if (iter == _in.MemberEnd() || !iter->value.IsArray()) {
+        logMsg("ERROR: TopoJSON missing '%s' array\n", _name);
+        return nullptr;
+    }
+    
+    return &iter->value;
+    
+}
+
+void TopoJson::extractTopology(const rapidjson::Value& _in, Topology& _out, const MapTile& _tile) {
+    
+    const auto& transformIter = _in.FindMember("transform");
+    
+    if (transformIter != _in.MemberEnd()) {
+        const rapidjson::Value& transform = transformIter->value;
+        const auto& scaleIter = transform.IsObject() ? transform.FindMember("scale") : transform.MemberEnd();
+        const auto& translateIter = transform.IsObject() ? transform.FindMember("translate") : transform.MemberEnd();
+        
+        if (scaleIter == transform.MemberEnd() || translateIter == transform.MemberEnd() ||
+            !isPosition(scaleIter->value) || !isPosition(translateIter->value)) {
+            logMsg("ERROR: TopoJSON 'transform' needs 'scale' and 'translate' arrays; positions are read unquantized\n");
+        } else {
+            const rapidjson::Value& scale = scaleIter->value;
+            const rapidjson::Value& translate = translateIter->value;
+            _out.scale = glm::dvec2(scale[0].GetDouble(), scale[1].GetDouble());
+            _out.translate = glm::dvec2(translate[0].GetDouble(), translate[1].GetDouble());
+            _out.quantized = true;
+        }
+    }
+    
+    const rapidjson::Value* arcs = findArray(_in, "arcs");
+    
+    if (!arcs) {
+        return;
+    }
+    
+    // Every arc is decoded exactly once here, no matter how many geometries reference it
+    _out.arcs.reserve(arcs->Size());
+    
+    std::vector<glm::dvec2> lonLats;
+    
+    for (auto arcJson = arcs->Begin(); arcJson != arcs->End(); ++arcJson) {
+        
+        lonLats.clear();
+        
+        if (!arcJson->IsArray()) {
+            // Keep the arc indices of the following arcs, with an arc that references skip
+            logMsg("ERROR: TopoJSON arc %u is not an array\n", (unsigned int)_out.arcs.size());
+            _out.arcs.emplace_back();
+            continue;
+        }
+        
+        lonLats.reserve(arcJson->Size());
+        
+        // Positions of quantized arcs are deltas from the previous position
+        int64_t x = 0;
+        int64_t y = 0;
+        
+        for (auto position = arcJson->Begin(); position != arcJson->End(); ++position) {
+            
+            if (!isPosition(*position)) {
+                logMsg("WARNING: Skipping invalid position in TopoJSON arc %u\n", (unsigned int)_out.arcs.size());
+                continue;
+            }
+            
+            if (_out.quantized) {
+                x += (int64_t)(*position)[0].GetDouble();
+                y += (int64_t)(*position)[1].GetDouble();
+                lonLats.emplace_back(x * _out.scale.x + _out.translate.x, y * _out.scale.y + _out.translate.y);
+            } else {
+                lonLats.emplace_back((*position)[0].GetDouble(), (*position)[1].GetDouble());
+            }
+        }
+        
+        // Each arc is projected in one batch
+        _out.arcs.emplace_back(lonLats.size());
+        _tile.getProjection()->LonLatToTileCoords(lonLats.data(), lonLats.size(), _tile.getOrigin(), _tile.getInverseScale(), _out.arcs.back().data());
+    }
+    
+}
+
+void TopoJson::extractPoint(const rapidjson::Value& _in, Point& _out, const Topology& _topology, const MapTile& _tile) {
+    
+    if (!isPosition(_in)) {
+        logMsg("WARNING: Invalid TopoJSON point position\n");
+        _out = Point(0.f, 0.f, 0.f);
+        return;
+    }
+    
+    // Point positions are quantized but, unlike arcs, not delta-encoded
+    glm::dvec2 lonLat(_in[0].GetDouble(), _in[1].GetDouble());
+    
+    if (_topology.quantized) {
+        lonLat = lonLat * _topology.scale + _topology.translate;
+    }
+    
+    _tile.getProjection()->LonLatToTileCoords(&lonLat, 1, _tile.getOrigin(), _tile.getInverseScale(), &_out);
+    
+}
+
+void TopoJson::extractLine(const rapidjson::Value& _arcs, Line& _out, const Topology& _topology) {
+    
+    if (!_arcs.IsArray()) {
+        logMsg("ERROR: TopoJSON line arcs are not an array\n");
+        return;
+    }
+    
+    for (auto arcRef = _arcs.Begin(); arcRef != _arcs.End(); ++arcRef) {
+        
+        if (!arcRef->IsInt()) {
+            logMsg("ERROR: TopoJSON arc reference is not an integer\n");
+            continue;
+        }
+        
+        // A negative reference ~i means arc i traversed in reverse
+        int index = arcRef->GetInt();
+        bool reversed = index < 0;
+        size_t arcIndex = reversed ? ~index : index;
+        
+        if (arcIndex >= _topology.arcs.size()) {
+            logMsg("ERROR: TopoJSON arc index %d out of range\n", index);
+            continue;
+        }
+        
+        const Line& arc = _topology.arcs[arcIndex];
+        
+        if (arc.empty()) {
+            continue;
+        }
+        
+        // Consecutive arcs share their end points, so the first point of each following arc is skipped
+        size_t skip = _out.empty() ? 0 : 1;
+        _out.reserve(_out.size() + arc.size() - skip);
+        
+        if (reversed) {
+            _out.insert(_out.end(), arc.rbegin() + skip, arc.rend());
+        } else {
+            _out.insert(_out.end(), arc.begin() + skip, arc.end());
+        }
+    }
+    
+}
+
+void TopoJson::extractPoly(const rapidjson::Value& _arcs, Polygon& _out, const Topology& _topology) {
+    
+    if (!_arcs.IsArray()) {
+        logMsg("ERROR: TopoJSON polygon arcs are not an array\n");
+        return;
+    }
+    
+    _out.reserve(_arcs.Size());
+    
+    for (auto ringArcs = _arcs.Begin(); ringArcs != _arcs.End(); ++ringArcs) {
+        _out.emplace_back();
+        extractLine(*ringArcs, _out.back(), _topology);
+    }
+    
+}
+
+bool TopoJson::extractFeature(const rapidjson::Value& _in, Feature& _out, const Topology& _topology, const MapTile& _tile) {
+    
+    // Copy properties into tile data
+    
+    const auto& propertiesIter = _in.FindMember("properties");
+    
+    if (propertiesIter != _in.MemberEnd() && propertiesIter->value.IsObject()) {
+        GeoJson::extractProperties(propertiesIter->value, _out.props, _tile);
+    }
+    
+    // Copy geometry into tile data, assembled from the shared arcs
+    
+    const auto& typeIter = _in.FindMember("type");
+    
+    if (typeIter == _in.MemberEnd() || !typeIter->value.IsString()) {
+        logMsg("ERROR: TopoJSON geometry without a 'type' string\n");
+        return false;
+    }
+    
+    const std::string& geometryType = typeIter->value.GetString();
+    
+    if (geometryType.compare("Point") == 0) {
+        
+        const auto& coordsIter = _in.FindMember("coordinates");
+        
+        _out.geometryType = GeometryType::POINTS;
+        
+        if (coordsIter == _in.MemberEnd()) {
+            logMsg("ERROR: TopoJSON Point missing 'coordinates'\n");
+            return false;
+        }
+        
+        _out.points.emplace_back();
+        extractPoint(coordsIter->value, _out.points.back(), _topology, _tile);
+        
+    } else if (geometryType.compare("MultiPoint") == 0) {
+        
+        _out.geometryType = GeometryType::POINTS;
+        const rapidjson::Value* coords = findArray(_in, "coordinates");
+        if (!coords) { return false; }
+        for (auto pointCoords = coords->Begin(); pointCoords != coords->End(); ++pointCoords) {
+            _out.points.emplace_back();
+            extractPoint(*pointCoords, _out.points.back(), _topology, _tile);
+        }
+        
+    } else if (geometryType.compare("LineString") == 0) {
+        
+        _out.geometryType = GeometryType::LINES;
+        const rapidjson::Value* arcs = findArray(_in, "arcs");
+        if (!arcs) { return false; }
+        _out.lines.emplace_back();
+        extractLine(*arcs, _out.lines.back(), _topology);
+        
+    } else if (geometryType.compare("MultiLineString") == 0) {
+        
+        _out.geometryType = GeometryType::LINES;
+        const rapidjson::Value* arcs = findArray(_in, "arcs");
+        if (!arcs) { return false; }
+        for (auto lineArcs = arcs->Begin(); lineArcs != arcs->End(); ++lineArcs) {
+            _out.lines.emplace_back();
+            extractLine(*lineArcs, _out.lines.back(), _topology);
+        }
+        
+    } else if (geometryType.compare("Polygon") == 0) {
+        
+        _out.geometryType = GeometryType::POLYGONS;
+        const rapidjson::Value* arcs = findArray(_in, "arcs");
+        if (!arcs) { return false; }
+        _out.polygons.emplace_back();
+        extractPoly(*arcs, _out.polygons.back(), _topology);
+        
+    } else if (geometryType.compare("MultiPolygon") == 0) {
+        
+        _out.geometryType = GeometryType::POLYGONS;
+        const rapidjson::Value* arcs = findArray(_in, "arcs");
+        if (!arcs) { return false; }
+        for (auto polyArcs = arcs->Begin(); polyArcs != arcs->End(); ++polyArcs) {
+            _out.polygons.emplace_back();
+            extractPoly(*polyArcs, _out.polygons.back(), _topology);
+        }
+        
+    } else {
+        
+        logMsg("ERROR: Unknown TopoJSON geometry type '%s'\n", geometryType.c_str());
+        return false;
+        
+    }
+    
+    return true;
+    
+}
+
+// Adds the geometries of the collection _in to _out; properties of the collection apply to the geometries
+// which don't set them, including those of nested collections. Feature ids are not kept, as <Feature> has none
+static void extractCollection(const rapidjson::Value& _in, Layer& _out, const Properties& _inherited,
+                              const TopoJson::Topology& _topology, const MapTile& _tile) {
+    
+    if (!_in.IsObject()) {
+        logMsg("ERROR: TopoJSON geometry is not an object\n");
+        return;
+    }
+    
+    const rapidjson::Value* geometries = findArray(_in, "geometries");
+    
+    if (!geometries) {
+        return;
+    }
+    
+    for (auto featureJson = geometries->Begin(); featureJson != geometries->End(); ++featureJson) {
+        
+        if (!featureJson->IsObject()) {
+            logMsg("ERROR: TopoJSON geometry is not an object\n");
+            continue;
+        }
+        
+        // Nested collections are flattened into the layer
+        if (featureJson->HasMember("geometries")) {
+            Properties properties;
+            const auto& propertiesIter = featureJson->FindMember("properties");
+            if (propertiesIter != featureJson->MemberEnd() && propertiesIter->value.IsObject()) {
+                GeoJson::extractProperties(propertiesIter->value, properties, _tile);
+            }
+            properties.stringProps.insert(_inherited.stringProps.begin(), _inherited.stringProps.end());
+            properties.numericProps.insert(_inherited.numericProps.begin(), _inherited.numericProps.end());
+            extractCollection(*featureJson, _out, properties, _topology, _tile);
+            continue;
+        }
+        
+        _out.features.emplace_back();
+        Feature& feature = _out.features.back();
+        
+        if (!TopoJson::extractFeature(*featureJson, feature, _topology, _tile)) {
+            _out.features.pop_back();
+            continue;
+        }
+        
+        // insert() keeps the values the feature sets itself
+        feature.props.stringProps.insert(_inherited.stringProps.begin(), _inherited.stringProps.end());
+        feature.props.numericProps.insert(_inherited.numericProps.begin(), _inherited.numericProps.end());
+    }
+    
+}
+
+void TopoJson::extractLayer(const rapidjson::Value& _in, Layer& _out, const Topology& _topology, const MapTile& _tile) {
+    
+    Properties properties;
+    
+    if (_in.IsObject()) {
+        const auto& propertiesIter = _in.FindMember("properties");
+        if (propertiesIter != _in.MemberEnd() && propertiesIter->value.IsObject()) {
+            GeoJson::extractProperties(propertiesIter->value, properties, _tile);
+        }
+    }
+    
+    extractCollection(_in, _out, properties, _topology, _tile);
+    
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+
+#include "rapidjson/document.h"
+
+#include "mapTile.h"
+#include "tileData.h"
+
+namespace TopoJson {
+    
+    /* Shared data of a TopoJSON topology: the quantization transform and the arcs 
+     * referenced by every geometry, already decoded into tile coordinates */
+    struct Topology {
+        glm::dvec2 scale = { 1.0, 1.0 };
+        glm::dvec2 translate = { 0.0, 0.0 };
+        bool quantized = false;
+        std::vector<Line> arcs;
+    };
+    
+    void extractTopology(const rapidjson::Value& _in, Topology& _out, const MapTile& _tile);
+    
+    void extractPoint(const rapidjson::Value& _in, Point& _out, const Topology& _topology, const MapTile& _tile);
+    
+    void extractLine(const rapidjson::Value& _arcs, Line& _out, const Topology& _topology);
+    
+    void extractPoly(const rapidjson::Value& _arcs, Polygon& _out, const Topology& _topology);
+    
+    /* Returns false, logging the error, if _in has no valid geometry type or is missing its coordinates or arcs */
+    bool extractFeature(const rapidjson::Value& _in, Feature& _out, const Topology& _topology, const MapTile& _tile);
+    
+    /* Extracts the geometries of the GeometryCollection _in into _out; nested collections are flattened, with
+     * their properties applied to the geometries which don't set them. Invalid geometries are logged and skipped */
+    void extractLayer(const rapidjson::Value& _in, Layer& _out, const Topology& _topology, const MapTile& _tile);
+    
+}
@@ -10,22 +10,39 @@ public:
     TypedMesh(std::shared_ptr<VertexLayout> _vertexLayout, GLenum _drawMode, GLenum _hint = GL_STATIC_DRAW)
         : VboMesh(_vertexLayout, _drawMode, _hint) {};
 
+    /*
+     * Appends _vertices and their _indices (relative to the first of _vertices) to the mesh
+     */
     void addVertices(std::vector<T>&& _vertices,
                      std::vector<int>&& _indices) {
-        vertices.push_back(_vertices);
-        indices.push_back(_indices);
+        addData(reinterpret_cast<const GLbyte*>(_vertices.data()), _vertices.size(), _indices);
+    }
 
-        m_nVertices += _vertices.size();
-        m_nIndices += _indices.size();
+    /*
+     * Appends _vertex to the staging buffer of the mesh, to be uploaded as is; the vertices pushed since
+     * the last <addIndices()> call form one feature, and are drawn with the indices passed to the next one
+     */
+    void pushVertex(const T& _vertex) {
+        const GLbyte* bytes = reinterpret_cast<const GLbyte*>(&_vertex);
+        m_glVertexData.insert(m_glVertexData.end(), bytes, bytes + sizeof(T));
+        m_nPendingVertices++;
     }
 
-    virtual void compileVertexBuffer() override {
-        compile(vertices, indices);
+    /* Reserves room for the current feature to hold _count vertices in total */
+    void reserveVertices(size_t _count) {
+        if (_count > (size_t)m_nPendingVertices) {
+            reserveVertexBytes((_count - m_nPendingVertices) * sizeof(T));
+        }
     }
 
-protected:
-    
-    std::vector<std::vector<T>> vertices;
-    std::vector<std::vector<int>> indices;
+    /* Returns the number of vertices pushed for the current feature */
+    size_t pendingVertices() const {
+        return m_nPendingVertices;
+    }
+
+    /* Returns a copy of the vertex at _index among those pushed for the current feature */
+    T getPendingVertex(size_t _index) const {
+        return *reinterpret_cast<const T*>(&m_glVertexData[(m_nVertices + _index) * sizeof(T)]);
+    }
     
 };
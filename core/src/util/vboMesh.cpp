@@ -1,9 +1,44 @@
 #include "vboMesh.h"
+#include "vertexCache.h"
 #include "platform.h"
 
+#include <algorithm>
+#include <cmath>
+
+#ifdef PLATFORM_ANDROID
+#include <EGL/egl.h>
+#endif
+
 #define MAX_INDEX_VALUE 65535 // Maximum value of GLushort
+#define UNKNOWN_BUFFER ((GLuint)-1) // Binding of a target whose bound buffer is not known
 
 int VboMesh::s_validGeneration = 0;
+bool VboMesh::s_uintIndices = false;
+GLuint VboMesh::s_boundArrayBuffer = 0;
+GLuint VboMesh::s_boundElementArrayBuffer = 0;
+bool VboMesh::s_vertexArrays = false;
+GLuint VboMesh::s_boundVertexArray = 0;
+std::atomic<uint64_t> VboMesh::s_cacheTriangles(0);
+std::atomic<uint64_t> VboMesh::s_cacheMissesBefore(0);
+std::atomic<uint64_t> VboMesh::s_cacheMissesAfter(0);
+
+namespace {
+
+    // Entry points of vertex array objects, which are core in GL 3.0 and an extension elsewhere
+    typedef void (*GenVertexArraysFn)(GLsizei, GLuint*);
+    typedef void (*BindVertexArrayFn)(GLuint);
+    typedef void (*DeleteVertexArraysFn)(GLsizei, const GLuint*);
+
+    GenVertexArraysFn genVertexArraysFn = nullptr;
+    BindVertexArrayFn bindVertexArrayFn = nullptr;
+    DeleteVertexArraysFn deleteVertexArraysFn = nullptr;
+
+    bool hasExtension(const char* _name) {
+        const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+        return extensions && std::strstr(extensions, _name);
+    }
+
+}
 
 VboMesh::VboMesh() {
     m_glVertexBuffer = 0;
@@ -17,6 +52,8 @@ VboMesh::VboMesh() {
     m_isUploaded = false;
     m_isCompiled = false;
 
+    m_indexType = GL_UNSIGNED_SHORT;
+
     m_generation = -1;
 }
 
@@ -28,11 +65,66 @@ VboMesh::VboMesh(std::shared_ptr<VertexLayout> _vertexLayout, GLenum _drawMode,
 }
 
 VboMesh::~VboMesh() {
-    if (m_glVertexBuffer) glDeleteBuffers(1, &m_glVertexBuffer);
-    if (m_glIndexBuffer) glDeleteBuffers(1, &m_glIndexBuffer);
+    if (m_generation == s_validGeneration) {
+        deleteVertexArrays();
+    }
+    if (m_vertexArena) {
+        m_vertexArena->release(m_vertexRange);
+        m_indexArena->release(m_indexRange);
+    } else {
+        if (m_glVertexBuffer) deleteBuffer(GL_ARRAY_BUFFER, m_glVertexBuffer);
+        if (m_glIndexBuffer) deleteBuffer(GL_ELEMENT_ARRAY_BUFFER, m_glIndexBuffer);
+    }
+}
+
+void VboMesh::setBufferArenas(std::shared_ptr<BufferArena> _vertexArena, std::shared_ptr<BufferArena> _indexArena) {
+    if (m_hint != GL_STATIC_DRAW || m_isUploaded) {
+        return;
+    }
+    m_vertexArena = _vertexArena;
+    m_indexArena = _indexArena;
+}
+
+void VboMesh::bindBuffer(GLenum _target, GLuint _buffer) {
+    if (_target == GL_ELEMENT_ARRAY_BUFFER) {
+        // The element array binding is part of the vertex array state, leave those of meshes untouched
+        bindVertexArray(0);
+    }
+    GLuint& bound = _target == GL_ARRAY_BUFFER ? s_boundArrayBuffer : s_boundElementArrayBuffer;
+    if (bound != _buffer) {
+        glBindBuffer(_target, _buffer);
+        bound = _buffer;
+    }
+}
+
+void VboMesh::deleteBuffer(GLenum _target, GLuint _buffer) {
+    GLuint& bound = _target == GL_ARRAY_BUFFER ? s_boundArrayBuffer : s_boundElementArrayBuffer;
+    if (bound == _buffer) {
+        bound = 0; // Deleting a bound buffer unbinds it
+    }
+    glDeleteBuffers(1, &_buffer);
+}
+
+void VboMesh::bindVertexArray(GLuint _vertexArray) {
+    if (s_vertexArrays && s_boundVertexArray != _vertexArray) {
+        bindVertexArrayFn(_vertexArray);
+        s_boundVertexArray = _vertexArray;
+        // The element array buffer is now that recorded in _vertexArray
+        s_boundElementArrayBuffer = UNKNOWN_BUFFER;
+    }
+}
 
-    delete[] m_glVertexData;
-    delete[] m_glIndexData;
+void VboMesh::deleteVertexArrays() {
+    if (m_glVertexArrays.empty()) {
+        return;
+    }
+    for (GLuint vertexArray : m_glVertexArrays) {
+        if (vertexArray == s_boundVertexArray) {
+            bindVertexArray(0);
+        }
+    }
+    deleteVertexArraysFn(m_glVertexArrays.size(), m_glVertexArrays.data());
+    m_glVertexArrays.clear();
 }
 
 void VboMesh::setVertexLayout(std::shared_ptr<VertexLayout> _vertexLayout) {
@@ -61,7 +153,7 @@ void VboMesh::update(GLintptr _offset, GLsizei _size, unsigned char* _data) {
         logMsg("WARNING: wrong usage hint provided to the Vbo\n");
     }
 
-    std::memcpy(m_glVertexData + _offset, _data, _size);
+    std::memcpy(m_glVertexData.data() + _offset, _data, _size);
 
     m_dirtyOffset = _offset;
     m_dirtySize = _size;
@@ -71,7 +163,7 @@ void VboMesh::update(GLintptr _offset, GLsizei _size, unsigned char* _data) {
 
 void VboMesh::subDataUpload() {
     if (m_dirtySize != 0) {
-        glBindBuffer(GL_ARRAY_BUFFER, m_glVertexBuffer);
+        bindBuffer(GL_ARRAY_BUFFER, m_glVertexBuffer);
 
         long vertexBytes = m_nVertices * m_vertexLayout->getStride();
 
@@ -83,10 +175,10 @@ void VboMesh::subDataUpload() {
 
             // if this buffer is still used by gpu on current frame this call will not wait
             // for the frame to finish using the vbo but directly upload the data
-            glBufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData, m_hint);
+            glBufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData.data(), m_hint);
         } else {
             // perform simple sub data upload for part of the buffer
-            glBufferSubData(GL_ARRAY_BUFFER, m_dirtyOffset, m_dirtySize, m_glVertexData + m_dirtyOffset);
+            glBufferSubData(GL_ARRAY_BUFFER, m_dirtyOffset, m_dirtySize, m_glVertexData.data() + m_dirtyOffset);
         }
 
         m_dirtyOffset = 0;
@@ -97,36 +189,68 @@ void VboMesh::subDataUpload() {
 }
 
 void VboMesh::upload() {
-    // Generate vertex buffer, if needed
-    if (m_glVertexBuffer == 0) {
-        glGenBuffers(1, &m_glVertexBuffer);
-    }
 
     // TODO check if compiled?
-    // Buffer vertex data
+
+    // Buffers may change, vertex arrays are recorded again on draw
+    deleteVertexArrays();
     int vertexBytes = m_nVertices * m_vertexLayout->getStride();
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_glVertexBuffer);
-    glBufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData, m_hint);
+    const GLvoid* indexData = nullptr;
+    GLsizeiptr indexBytes = 0;
 
-    if (m_glIndexData) {
+    if (!m_glIndexData.empty()) {
+        indexData = m_glIndexData.data();
+        indexBytes = m_nIndices * sizeof(GLushort);
+    } else if (!m_glIndexDataUint.empty()) {
+        indexData = m_glIndexDataUint.data();
+        indexBytes = m_nIndices * sizeof(GLuint);
+    }
+
+    if (m_vertexArena) {
+
+        // Sub-allocate from the shared buffers
+        m_vertexArena->release(m_vertexRange);
+        m_vertexRange = m_vertexArena->allocate(vertexBytes, m_glVertexData.data());
+        m_glVertexBuffer = m_vertexArena->getBuffer(m_vertexRange);
 
-        if (m_glIndexBuffer == 0) {
-            glGenBuffers(1, &m_glIndexBuffer);
+        if (indexData) {
+            m_indexArena->release(m_indexRange);
+            m_indexRange = m_indexArena->allocate(indexBytes, indexData);
+            m_glIndexBuffer = m_indexArena->getBuffer(m_indexRange);
         }
 
-        // Buffer element index data
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_glIndexBuffer);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndices * sizeof(GLushort), m_glIndexData, m_hint);
-    }
+    } else {
 
-    // m_glVertexData.resize(0);
-    // m_glIndexData.resize(0);
+        // Generate vertex buffer, if needed
+        if (m_glVertexBuffer == 0) {
+            glGenBuffers(1, &m_glVertexBuffer);
+        }
 
-    // TODO: For now, we retain copies of the vertex and index data in CPU memory to allow VBOs
-    // to easily rebuild themselves after GL context loss. For optimizing memory usage (and for
-    // other reasons) we'll want to change this in the future. This probably means going back to
-    // data sources and styles to rebuild the vertex data.
+        // Buffer vertex data
+        bindBuffer(GL_ARRAY_BUFFER, m_glVertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData.data(), m_hint);
+
+        if (indexData) {
+
+            if (m_glIndexBuffer == 0) {
+                glGenBuffers(1, &m_glIndexBuffer);
+            }
+
+            // Buffer element index data
+            bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_glIndexBuffer);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indexData, m_hint);
+        }
+    }
+
+    // Static meshes may drop their CPU-side copy; they are then rebuilt from their tile data
+    // after a GL context loss instead of being uploaded again
+    if (!m_retainData && m_hint == GL_STATIC_DRAW) {
+        std::vector<GLbyte>().swap(m_glVertexData);
+        std::vector<GLushort>().swap(m_glIndexData);
+        std::vector<GLuint>().swap(m_glIndexDataUint);
+        m_dataReleased = true;
+    }
 
     m_generation = s_validGeneration;
 
@@ -134,6 +258,329 @@ void VboMesh::upload() {
 
 }
 
+size_t VboMesh::uploadIfNeeded() {
+
+    checkValidity();
+
+    if (!m_isCompiled || m_isUploaded || m_dataReleased || m_nVertices == 0) {
+        return 0;
+    }
+
+    size_t bytes = m_glVertexData.size() + m_glIndexData.size() * sizeof(GLushort) + m_glIndexDataUint.size() * sizeof(GLuint);
+
+    upload();
+
+    return bytes;
+
+}
+
+void VboMesh::addData(const GLbyte* _vertexData, size_t _nVertices, const std::vector<int>& _indices) {
+
+    if (m_isCompiled) {
+        logMsg("WARNING: Adding data to a compiled mesh\n");
+        return;
+    }
+
+    int stride = m_vertexLayout->getStride();
+    m_glVertexData.insert(m_glVertexData.end(), _vertexData, _vertexData + _nVertices * stride);
+    m_nPendingVertices += _nVertices;
+
+    addIndices(_indices);
+}
+
+void VboMesh::addIndices(const std::vector<int>& _indices) {
+
+    if (m_isCompiled) {
+        logMsg("WARNING: Adding data to a compiled mesh\n");
+        size_t pendingBytes = m_nPendingVertices * m_vertexLayout->getStride();
+        m_glVertexData.resize(m_glVertexData.size() >= pendingBytes ? m_glVertexData.size() - pendingBytes : 0);
+        m_nPendingVertices = 0;
+        return;
+    }
+
+    for (int idx : _indices) {
+        m_glIndexDataUint.push_back(idx + m_nVertices);
+    }
+    m_features.emplace_back(_indices.size(), m_nPendingVertices);
+
+    m_nVertices += m_nPendingVertices;
+    m_nIndices += _indices.size();
+    m_nPendingVertices = 0;
+}
+
+void VboMesh::reserveVertexBytes(size_t _bytes) {
+
+    size_t needed = m_glVertexData.size() + _bytes;
+
+    if (needed > m_glVertexData.capacity()) {
+        m_glVertexData.reserve(std::max(needed, 2 * m_glVertexData.capacity()));
+    }
+}
+
+void VboMesh::optimizeBatches() {
+
+    if (!m_optimizeVertexCache || m_drawMode != GL_TRIANGLES) {
+        return;
+    }
+
+    int stride = m_vertexLayout->getStride();
+    float acmrBefore = VertexCache::acmr(m_glIndexDataUint.data(), m_nIndices);
+
+    uint32_t vertexOffset = 0;
+    size_t indexOffset = 0;
+
+    for (auto& batch : m_vertexOffsets) {
+        GLuint* indices = &m_glIndexDataUint[indexOffset];
+
+        VertexCache::optimizeTriangles(indices, batch.first, vertexOffset, batch.second);
+        VertexCache::optimizeVertices(indices, batch.first, vertexOffset, &m_glVertexData[vertexOffset * stride], batch.second, stride);
+
+        indexOffset += batch.first;
+        vertexOffset += batch.second;
+    }
+
+    float acmrAfter = VertexCache::acmr(m_glIndexDataUint.data(), m_nIndices);
+
+    uint64_t triangles = m_nIndices / 3;
+    s_cacheTriangles += triangles;
+    s_cacheMissesBefore += (uint64_t)std::round(acmrBefore * triangles);
+    s_cacheMissesAfter += (uint64_t)std::round(acmrAfter * triangles);
+}
+
+uint64_t VboMesh::getVertexCacheStats(float& _acmrBefore, float& _acmrAfter) {
+
+    uint64_t triangles = s_cacheTriangles;
+
+    _acmrBefore = triangles > 0 ? (float)s_cacheMissesBefore / triangles : 0.f;
+    _acmrAfter = triangles > 0 ? (float)s_cacheMissesAfter / triangles : 0.f;
+
+    return triangles;
+}
+
+void VboMesh::resetVertexCacheStats() {
+
+    s_cacheTriangles = 0;
+    s_cacheMissesBefore = 0;
+    s_cacheMissesAfter = 0;
+}
+
+void VboMesh::splitLargeFeatures() {
+
+    bool needsSplit = false;
+    for (const auto& feature : m_features) {
+        needsSplit |= feature.second > MAX_INDEX_VALUE;
+    }
+
+    if (!needsSplit) {
+        return;
+    }
+
+    int stride = m_vertexLayout->getStride();
+
+    std::vector<GLbyte> vertexData;
+    std::vector<GLuint> indexData;
+    std::vector<std::pair<uint32_t, uint32_t>> features;
+    vertexData.reserve(m_glVertexData.size());
+    indexData.reserve(m_glIndexDataUint.size());
+
+    // Vertex of the current chunk each vertex of the split feature is copied to
+    const GLuint unmapped = (GLuint)-1;
+    std::vector<GLuint> remap;
+
+    uint32_t vertexOffset = 0; // first vertex of the feature in m_glVertexData
+    size_t indexOffset = 0;
+
+    for (const auto& feature : m_features) {
+        uint32_t nIndices = feature.first;
+        uint32_t nVertices = feature.second;
+        const GLuint* indices = m_glIndexDataUint.data() + indexOffset;
+        GLuint newOffset = vertexData.size() / stride;
+
+        if (nVertices <= MAX_INDEX_VALUE) {
+
+            vertexData.insert(vertexData.end(), m_glVertexData.data() + vertexOffset * stride, m_glVertexData.data() + (vertexOffset + nVertices) * stride);
+            for (uint32_t i = 0; i < nIndices; i++) {
+                indexData.push_back(indices[i] - vertexOffset + newOffset);
+            }
+            features.push_back(feature);
+
+        } else if (m_drawMode != GL_TRIANGLES || nIndices == 0) {
+
+            logMsg("WARNING: Dropping a feature of %d vertices, too large to draw without 32 bit indices\n", nVertices);
+
+        } else {
+
+            // Fill chunks triangle by triangle, copying each vertex once into every chunk that uses it
+            remap.assign(nVertices, unmapped);
+            std::vector<GLuint> chunkVertices; // vertices of the feature copied to the current chunk
+            size_t chunkIndices = 0;
+
+            auto endChunk = [&]() {
+                features.emplace_back(chunkIndices, chunkVertices.size());
+                newOffset += chunkVertices.size();
+                for (GLuint v : chunkVertices) { remap[v] = unmapped; }
+                chunkVertices.clear();
+                chunkIndices = 0;
+            };
+
+            for (uint32_t i = 0; i + 2 < nIndices; i += 3) {
+                GLuint triangle[3] = { indices[i] - vertexOffset, indices[i + 1] - vertexOffset, indices[i + 2] - vertexOffset };
+
+                size_t needed = 0;
+                for (int k = 0; k < 3; k++) {
+                    bool repeated = (k > 0 && triangle[k] == triangle[0]) || (k > 1 && triangle[k] == triangle[1]);
+                    needed += remap[triangle[k]] == unmapped && !repeated;
+                }
+
+                if (chunkVertices.size() + needed > MAX_INDEX_VALUE) {
+                    endChunk();
+                }
+
+                for (GLuint v : triangle) {
+                    if (remap[v] == unmapped) {
+                        remap[v] = chunkVertices.size();
+                        chunkVertices.push_back(v);
+                        const GLbyte* vertex = m_glVertexData.data() + (vertexOffset + v) * stride;
+                        vertexData.insert(vertexData.end(), vertex, vertex + stride);
+                    }
+                    indexData.push_back(newOffset + remap[v]);
+                }
+                chunkIndices += 3;
+            }
+
+            if (chunkIndices > 0) {
+                endChunk();
+            }
+
+            logMsg("NOTICE: Split a feature of %d vertices for 16 bit indices\n", nVertices);
+        }
+
+        vertexOffset += nVertices;
+        indexOffset += nIndices;
+    }
+
+    m_glVertexData.swap(vertexData);
+    m_glIndexDataUint.swap(indexData);
+    m_features.swap(features);
+    m_nVertices = m_glVertexData.size() / stride;
+    m_nIndices = m_glIndexDataUint.size();
+
+}
+
+void VboMesh::compileVertexBuffer() {
+
+    if (m_isCompiled) {
+        return;
+    }
+
+    if (m_nIndices == 0) {
+
+        m_vertexOffsets.emplace_back(0, m_nVertices);
+
+    } else if (m_nVertices > MAX_INDEX_VALUE && s_uintIndices) {
+
+        // Draw the whole mesh at once
+        m_indexType = GL_UNSIGNED_INT;
+        m_vertexOffsets.emplace_back(m_nIndices, m_nVertices);
+
+        optimizeBatches();
+
+    } else {
+
+        splitLargeFeatures();
+
+        // Split into as few batches as GLushort allows, balanced in size,
+        // without breaking up the geometry of a feature
+        uint32_t nBatches = m_nVertices / (MAX_INDEX_VALUE + 1) + 1;
+        uint32_t batchTarget = m_nVertices / nBatches;
+
+        if (nBatches > 1) {
+            logMsg("NOTICE: Big Mesh %d, split into %d batches\n", m_nVertices, nBatches);
+        }
+
+        uint32_t batchIndices = 0, batchVertices = 0;
+
+        for (auto& feature : m_features) {
+            uint32_t nIndices = feature.first;
+            uint32_t nVertices = feature.second;
+
+            if (batchVertices > 0 && (batchVertices + nVertices > MAX_INDEX_VALUE || batchVertices >= batchTarget)) {
+                m_vertexOffsets.emplace_back(batchIndices, batchVertices);
+                batchIndices = 0;
+                batchVertices = 0;
+            }
+
+            batchIndices += nIndices;
+            batchVertices += nVertices;
+        }
+
+        m_vertexOffsets.emplace_back(batchIndices, batchVertices);
+
+        optimizeBatches();
+
+        // Rebase the indices to their batch
+        m_glIndexData.reserve(m_nIndices);
+
+        uint32_t vertexOffset = 0; // first vertex of the batch
+        size_t iPos = 0;
+
+        for (auto& batch : m_vertexOffsets) {
+            for (size_t i = 0; i < batch.first; i++) {
+                m_glIndexData.push_back(m_glIndexDataUint[iPos++] - vertexOffset);
+            }
+            vertexOffset += batch.second;
+        }
+
+        std::vector<GLuint>().swap(m_glIndexDataUint);
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>>().swap(m_features);
+
+    m_isCompiled = true;
+}
+
+void VboMesh::detectGLSupport() {
+
+#if defined(PLATFORM_ANDROID) || defined(PLATFORM_IOS) || defined(PLATFORM_RPI)
+    s_uintIndices = hasExtension("GL_OES_element_index_uint");
+#else
+    s_uintIndices = true;
+#endif
+
+#if defined(PLATFORM_LINUX)
+    const char* version = reinterpret_cast<const char*>(glGetString(GL_VERSION));
+    if ((version && std::atoi(version) >= 3) || hasExtension("GL_ARB_vertex_array_object")) {
+        genVertexArraysFn = glGenVertexArrays;
+        bindVertexArrayFn = glBindVertexArray;
+        deleteVertexArraysFn = glDeleteVertexArrays;
+    }
+#elif defined(PLATFORM_OSX)
+    if (hasExtension("GL_APPLE_vertex_array_object")) {
+        genVertexArraysFn = glGenVertexArraysAPPLE;
+        bindVertexArrayFn = glBindVertexArrayAPPLE;
+        deleteVertexArraysFn = glDeleteVertexArraysAPPLE;
+    }
+#elif defined(PLATFORM_IOS)
+    if (hasExtension("GL_OES_vertex_array_object")) {
+        genVertexArraysFn = glGenVertexArraysOES;
+        bindVertexArrayFn = glBindVertexArrayOES;
+        deleteVertexArraysFn = glDeleteVertexArraysOES;
+    }
+#elif defined(PLATFORM_ANDROID)
+    if (hasExtension("GL_OES_vertex_array_object")) {
+        genVertexArraysFn = reinterpret_cast<GenVertexArraysFn>(eglGetProcAddress("glGenVertexArraysOES"));
+        bindVertexArrayFn = reinterpret_cast<BindVertexArrayFn>(eglGetProcAddress("glBindVertexArrayOES"));
+        deleteVertexArraysFn = reinterpret_cast<DeleteVertexArraysFn>(eglGetProcAddress("glDeleteVertexArraysOES"));
+    }
+#endif
+
+    s_vertexArrays = genVertexArraysFn && bindVertexArrayFn && deleteVertexArraysFn;
+
+    logMsg("NOTICE: 32 bit indices %s, vertex array objects %s\n",
+           s_uintIndices ? "supported" : "not supported", s_vertexArrays ? "supported" : "not supported");
+
+}
+
 void VboMesh::draw(const std::shared_ptr<ShaderProgram> _shader) {
 
     checkValidity();
@@ -142,6 +589,9 @@ void VboMesh::draw(const std::shared_ptr<ShaderProgram> _shader) {
 
     if (m_nVertices == 0) return;
 
+    // Released data can't be uploaded again, the mesh waits to be rebuilt
+    if (m_dataReleased && !m_isUploaded) return;
+
     // Ensure that geometry is buffered into GPU
     if (!m_isUploaded) {
         upload();
@@ -149,32 +599,59 @@ void VboMesh::draw(const std::shared_ptr<ShaderProgram> _shader) {
         subDataUpload();
     }
 
-    // Bind buffers for drawing
-    glBindBuffer(GL_ARRAY_BUFFER, m_glVertexBuffer);
+    // Enable shader program
+    _shader->use();
 
-    if (m_nIndices > 0) {
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_glIndexBuffer);
+    // Vertex arrays record the attribute locations of one build of the program
+    bool useVertexArrays = s_vertexArrays;
+    bool recordVertexArrays = false;
+
+    if (useVertexArrays && (m_glVertexArrays.empty() || m_vertexArraysBuildId != _shader->getBuildId())) {
+        deleteVertexArrays();
+        m_glVertexArrays.resize(m_vertexOffsets.size());
+        genVertexArraysFn(m_glVertexArrays.size(), m_glVertexArrays.data());
+        m_vertexArraysBuildId = _shader->getBuildId();
+        recordVertexArrays = true;
     }
 
-    // Enable shader program
-    _shader->use();
+    // Bind buffers for drawing; the element array buffer is recorded in the vertex arrays
+    bindBuffer(GL_ARRAY_BUFFER, m_glVertexBuffer);
+
+    if (m_nIndices > 0 && !useVertexArrays) {
+        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_glIndexBuffer);
+    }
 
     size_t indiceOffset = 0;
     size_t vertexOffset = 0;
 
-    for (auto& o : m_vertexOffsets) {
-        uint32_t nIndices = o.first;
-        uint32_t nVertices = o.second;
+    // Start of the mesh data within its buffers
+    size_t vertexByteOffset = m_vertexRange.offset;
+    size_t indexByteOffset = m_indexRange.offset;
+
+    for (size_t batch = 0; batch < m_vertexOffsets.size(); batch++) {
+        uint32_t nIndices = m_vertexOffsets[batch].first;
+        uint32_t nVertices = m_vertexOffsets[batch].second;
+
+        size_t byteOffset = vertexByteOffset + vertexOffset * m_vertexLayout->getStride();
 
-        size_t byteOffset = vertexOffset * m_vertexLayout->getStride();
+        if (useVertexArrays) {
+            bindVertexArray(m_glVertexArrays[batch]);
 
-        // Enable vertex attribs via vertex layout object
-        m_vertexLayout->enable(*_shader, byteOffset);
+            if (recordVertexArrays) {
+                if (m_nIndices > 0) {
+                    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_glIndexBuffer);
+                }
+                m_vertexLayout->enableVertexArray(*_shader, byteOffset);
+            }
+        } else {
+            // Enable vertex attribs via vertex layout object
+            m_vertexLayout->enable(*_shader, byteOffset);
+        }
 
         // Draw as elements or arrays
         if (nIndices > 0) {
-            glDrawElements(m_drawMode, nIndices, GL_UNSIGNED_SHORT,
-                           (void*)(indiceOffset * sizeof(GLushort)));
+            size_t indexSize = m_indexType == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort);
+            glDrawElements(m_drawMode, nIndices, m_indexType, (void*)(indexByteOffset + indiceOffset * indexSize));
         } else if (nVertices > 0) {
             glDrawArrays(m_drawMode, 0, nVertices);
         }
@@ -190,6 +667,9 @@ void VboMesh::checkValidity() {
         m_glVertexBuffer = 0;
         m_glIndexBuffer = 0;
 
+        // Vertex array objects are gone with the context
+        m_glVertexArrays.clear();
+
         m_generation = s_validGeneration;
     }
 }
@@ -198,4 +678,10 @@ void VboMesh::invalidateAllVBOs() {
 
     ++s_validGeneration;
 
+    s_boundArrayBuffer = 0;
+    s_boundElementArrayBuffer = 0;
+    s_boundVertexArray = 0;
+
+    VertexLayout::clearCache();
+
 }
@@ -1,10 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <memory>
 
 #include "gl.h"
 #include "vertexLayout.h"
+#include "bufferArena.h"
 #include <cstring>
 #include <cstdlib>
 
@@ -48,7 +50,47 @@ public:
         return m_nIndices;
     }
 
-    virtual void compileVertexBuffer() = 0;
+    /* Returns the GL handle of the vertex buffer, 0 until the mesh is first drawn */
+    GLuint getVertexBuffer() const {
+        return m_glVertexBuffer;
+    }
+
+    /*
+     * Sets whether the vertex and index data is kept in CPU memory after upload (the default); without it,
+     * static meshes free their data once uploaded and must be rebuilt when the GL context is lost
+     */
+    void setRetainData(bool _retain) { m_retainData = _retain; }
+
+    /*
+     * Sets whether compileVertexBuffer() reorders triangles and vertices for the GPU vertex cache; only
+     * applies to GL_TRIANGLES meshes. The pass is meant to run on the thread building the mesh
+     */
+    void setOptimizeVertexCache(bool _optimize) { m_optimizeVertexCache = _optimize; }
+
+    /*
+     * Uploads the vertices and indices of this mesh into ranges of the given arenas instead of buffer objects
+     * of its own; only applies to static meshes, set before upload
+     */
+    void setBufferArenas(std::shared_ptr<BufferArena> _vertexArena, std::shared_ptr<BufferArena> _indexArena);
+
+    /*
+     * Returns true if the GL buffers of this mesh were lost with the context and can't be restored
+     * because its CPU-side data was released after upload
+     */
+    bool needsRebuild() const {
+        return m_dataReleased && (!m_isUploaded || m_generation != s_validGeneration);
+    }
+
+    /*
+     * Ends the current feature: the vertices pushed into the staging buffer since the previous feature
+     * (see <TypedMesh::pushVertex()>) are drawn with _indices, relative to the first of them
+     */
+    void addIndices(const std::vector<int>& _indices);
+
+    /*
+     * Finishes the added geometry for upload; no more vertices or indices can be added afterwards
+     */
+    virtual void compileVertexBuffer();
 
     /*
      * Copies all added vertices and indices into OpenGL buffer objects; After geometry is uploaded,
@@ -57,6 +99,12 @@ public:
     void upload();
     void subDataUpload();
 
+    /*
+     * Uploads the geometry of this mesh if it is compiled and not yet in GL buffers of the current context;
+     * returns the number of bytes uploaded
+     */
+    size_t uploadIfNeeded();
+
     /*
      * Renders the geometry in this mesh using the ShaderProgram _shader; if geometry has not already
      * been uploaded it will be uploaded at this point
@@ -71,26 +119,81 @@ public:
     
     static void invalidateAllVBOs();
 
+    /*
+     * Checks whether the GL context can draw with 32 bit indices (always on desktop GL, with
+     * OES_element_index_uint on GLES2) and supports vertex array objects (GL 3.0, or through
+     * APPLE_vertex_array_object, ARB_vertex_array_object or OES_vertex_array_object); must be
+     * called on the GL thread before meshes are compiled
+     */
+    static void detectGLSupport();
+
+    static int getValidGeneration() { return s_validGeneration; }
+
+    /*
+     * Binds _buffer to _target unless it is bound already; all buffer bindings must go through this
+     * (or be restored afterwards) for the cached bindings to stay correct
+     */
+    static void bindBuffer(GLenum _target, GLuint _buffer);
+
+    /* Deletes _buffer, forgetting its binding to _target */
+    static void deleteBuffer(GLenum _target, GLuint _buffer);
+
+    /* Returns the buffer last bound to _target by bindBuffer() */
+    static GLuint getBoundBuffer(GLenum _target) {
+        return _target == GL_ARRAY_BUFFER ? s_boundArrayBuffer : s_boundElementArrayBuffer;
+    }
+
+    /*
+     * Binds the vertex array object _vertexArray (0 for the default one) unless it is bound already;
+     * does nothing if vertex array objects are not supported
+     */
+    static void bindVertexArray(GLuint _vertexArray);
+
+    /*
+     * Returns the number of triangles optimized for the vertex cache since the last reset, and their
+     * average cache miss ratio (ACMR) before and after the optimization; counts meshes of every thread
+     */
+    static uint64_t getVertexCacheStats(float& _acmrBefore, float& _acmrAfter);
+
+    static void resetVertexCacheStats();
+
 protected:
 
     static int s_validGeneration; // Incremented when the GL context is invalidated
+    static bool s_uintIndices; // Whether GL_UNSIGNED_INT indices can be drawn
+    static GLuint s_boundArrayBuffer; // Buffers last bound by bindBuffer()
+    static GLuint s_boundElementArrayBuffer;
+    static bool s_vertexArrays; // Whether vertex array objects are supported
+    static GLuint s_boundVertexArray;
+    static std::atomic<uint64_t> s_cacheTriangles; // Totals of optimizeBatches(), see getVertexCacheStats()
+    static std::atomic<uint64_t> s_cacheMissesBefore;
+    static std::atomic<uint64_t> s_cacheMissesAfter;
     int m_generation; // Generation in which this mesh's GL handles were created
 
     // Used in draw for legth and offsets: sumIndices, sumVertices
     // needs to be set by compileVertexBuffers()
     std::vector<std::pair<uint32_t, uint32_t>> m_vertexOffsets;
 
+    // Number of indices and vertices of each addData() call, the boundaries at which
+    // compileVertexBuffer() may split the mesh into batches
+    std::vector<std::pair<uint32_t, uint32_t>> m_features;
+
     std::shared_ptr<VertexLayout> m_vertexLayout;
 
-    int m_nVertices;
+    int m_nVertices; // Vertices of the ended features
+    int m_nPendingVertices = 0; // Vertices pushed for the current feature, not counted in m_nVertices yet
     GLuint m_glVertexBuffer;
-    // Compiled vertices for upload
-    GLbyte* m_glVertexData = nullptr;
+    // Interleaved vertices, written by the style builders (or appended by addData()) and uploaded as is
+    std::vector<GLbyte> m_glVertexData;
 
     int m_nIndices;
     GLuint m_glIndexBuffer;
-    // Compiled  indices for upload
-    GLushort* m_glIndexData = nullptr;
+    // Indices rebased to the start of the mesh, appended to by addData(); uploaded as is for
+    // meshes drawn with GL_UNSIGNED_INT
+    std::vector<GLuint> m_glIndexDataUint;
+    // Indices rebased to their batch, for meshes drawn with GL_UNSIGNED_SHORT
+    std::vector<GLushort> m_glIndexData;
+    GLenum m_indexType;
 
     GLenum m_drawMode;
     GLenum m_hint;
@@ -98,63 +201,45 @@ protected:
     bool m_isUploaded;
     bool m_isCompiled;
     bool m_dirty;
+
+    bool m_retainData = true;
+    bool m_dataReleased = false;
+    bool m_optimizeVertexCache = false;
+
+    // Arenas holding the buffers of this mesh, if any, and the ranges allocated from them
+    std::shared_ptr<BufferArena> m_vertexArena;
+    std::shared_ptr<BufferArena> m_indexArena;
+    BufferArena::Range m_vertexRange;
+    BufferArena::Range m_indexRange;
+
+    // Vertex array object of each batch, recorded when first drawn with the program build <m_vertexArraysBuildId>
+    std::vector<GLuint> m_glVertexArrays;
+    int m_vertexArraysBuildId = -1;
     
     GLsizei m_dirtySize;
     GLintptr m_dirtyOffset;
     
     void checkValidity();
 
-    template <typename T>
-    void compile(std::vector<std::vector<T>>& _vertices,
-                 std::vector<std::vector<int>>& _indices) {
-
-        std::vector<std::vector<T>> vertices;
-        std::vector<std::vector<int>> indices;
-
-        // take over contents
-        std::swap(_vertices, vertices);
-        std::swap(_indices, indices);
-
-        int vertexOffset = 0, indexOffset = 0;
-
-        // Buffer positions: vertex byte and index short
-        int vPos = 0, iPos = 0;
-
-        int stride = m_vertexLayout->getStride();
-        m_glVertexData = new GLbyte[stride * m_nVertices];
-
-        bool useIndices = m_nIndices > 0;
-        if (useIndices) {
-            m_glIndexData = new GLushort[m_nIndices];
-        }
+    /* Deletes the vertex array objects of this mesh, if any */
+    void deleteVertexArrays();
 
-        for (size_t i = 0; i < vertices.size(); i++) {
-            auto curVertices = vertices[i];
-            size_t nVertices = curVertices.size();
-            int nBytes = nVertices * stride;
+    /* Reorders the indices and vertices of each batch in <m_vertexOffsets> for the vertex cache, if enabled */
+    void optimizeBatches();
 
-            std::memcpy(m_glVertexData + vPos, (GLbyte*)curVertices.data(), nBytes);
-            vPos += nBytes;
-
-            if (useIndices) {
-                if (vertexOffset + nVertices > MAX_INDEX_VALUE) {
-                    logMsg("NOTICE: Big Mesh %d\n", vertexOffset + nVertices);
-
-                    m_vertexOffsets.emplace_back(indexOffset, vertexOffset);
-                    vertexOffset = 0;
-                    indexOffset = 0;
-                }
+    /*
+     * Splits the triangles of features with more vertices than GLushort indices can address into features
+     * which fit, duplicating the vertices shared between them; features of other draw modes are dropped
+     */
+    void splitLargeFeatures();
 
-                for (int idx : indices[i]) {
-                    m_glIndexData[iPos++] = idx + vertexOffset;
-                }
-                indexOffset += indices[i].size();
-            }
-            vertexOffset += nVertices;
-        }
+    /*
+     * Appends _nVertices vertices of the layout's stride from _vertexData and their _indices, rebased to
+     * the start of the mesh
+     */
+    void addData(const GLbyte* _vertexData, size_t _nVertices, const std::vector<int>& _indices);
 
-        m_vertexOffsets.emplace_back(indexOffset, vertexOffset);
+    /* Reserves room for _bytes more bytes in the staging buffer, growing it geometrically */
+    void reserveVertexBytes(size_t _bytes);
 
-        m_isCompiled = true;
-    }
 };
@@ -0,0 +1,223 @@
+#include "vertexCache.h"
+
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+    const float CACHE_DECAY_POWER = 1.5f;
+    const float LAST_TRIANGLE_SCORE = 0.75f;
+    const float VALENCE_BOOST_SCALE = 2.0f;
+    const float VALENCE_BOOST_POWER = 0.5f;
+
+    struct VertexState {
+        int cachePosition = -1; // position in the modelled LRU cache, -1 if not in the cache
+        int remaining = 0; // triangles using this vertex which are not yet added
+        int firstTriangle = 0; // offset of this vertex's triangles in the adjacency list
+        float score = 0.f;
+    };
+
+    float vertexScore(const VertexState& _vertex) {
+
+        if (_vertex.remaining == 0) {
+            // No triangle needs this vertex anymore
+            return -1.f;
+        }
+
+        float score = 0.f;
+
+        if (_vertex.cachePosition >= 3) {
+            const float scaler = 1.f / (VERTEX_CACHE_SIZE - 3);
+            score = powf(1.f - (_vertex.cachePosition - 3) * scaler, CACHE_DECAY_POWER);
+        } else if (_vertex.cachePosition >= 0) {
+            // Vertices of the last triangle get a fixed score, so that it doesn't matter which
+            // of its edges the next triangle shares
+            score = LAST_TRIANGLE_SCORE;
+        }
+
+        // Boost vertices with few triangles left, so that lone triangles don't get left behind
+        score += VALENCE_BOOST_SCALE * powf((float)_vertex.remaining, -VALENCE_BOOST_POWER);
+
+        return score;
+    }
+
+}
+
+float VertexCache::acmr(const GLuint* _indices, size_t _nIndices, size_t _cacheSize) {
+
+    if (_nIndices < 3) {
+        return 0.f;
+    }
+
+    std::vector<GLuint> cache(_cacheSize);
+    size_t cached = 0;
+    size_t head = 0;
+    size_t misses = 0;
+
+    for (size_t i = 0; i < _nIndices; i++) {
+        bool hit = false;
+        for (size_t c = 0; c < cached && !hit; c++) {
+            hit = cache[c] == _indices[i];
+        }
+        if (!hit) {
+            misses++;
+            cache[head] = _indices[i];
+            head = (head + 1) % _cacheSize;
+            if (cached < _cacheSize) { cached++; }
+        }
+    }
+
+    return (float)misses / (_nIndices / 3);
+}
+
+void VertexCache::optimizeTriangles(GLuint* _indices, size_t _nIndices, GLuint _baseVertex, size_t _nVertices) {
+
+    size_t nTriangles = _nIndices / 3;
+
+    if (nTriangles < 2) {
+        return;
+    }
+
+    std::vector<VertexState> vertices(_nVertices);
+
+    // Build the lists of triangles using each vertex
+    for (size_t i = 0; i < nTriangles * 3; i++) {
+        vertices[_indices[i] - _baseVertex].remaining++;
+    }
+
+    int offset = 0;
+    for (auto& vertex : vertices) {
+        vertex.firstTriangle = offset;
+        offset += vertex.remaining;
+        vertex.score = vertexScore(vertex);
+    }
+
+    std::vector<int> vertexTriangles(offset);
+    std::vector<int> filled(_nVertices, 0);
+
+    for (size_t t = 0; t < nTriangles; t++) {
+        for (int k = 0; k < 3; k++) {
+            auto v = _indices[3 * t + k] - _baseVertex;
+            vertexTriangles[vertices[v].firstTriangle + filled[v]++] = t;
+        }
+    }
+
+    std::vector<float> triangleScores(nTriangles);
+    std::vector<bool> triangleAdded(nTriangles, false);
+
+    for (size_t t = 0; t < nTriangles; t++) {
+        for (int k = 0; k < 3; k++) {
+            triangleScores[t] += vertices[_indices[3 * t + k] - _baseVertex].score;
+        }
+    }
+
+    std::vector<GLuint> output;
+    output.reserve(nTriangles * 3);
+
+    // Modelled LRU cache, with room for the 3 vertices pushed in before evicting
+    std::vector<int> cache;
+    cache.reserve(VERTEX_CACHE_SIZE + 3);
+    std::vector<int> newCache;
+    newCache.reserve(VERTEX_CACHE_SIZE + 3);
+
+    size_t scanPosition = 0; // Triangles before this are all added
+    int bestTriangle = -1;
+
+    for (size_t added = 0; added < nTriangles; added++) {
+
+        if (bestTriangle < 0) {
+            // No triangle in the cache has a score, continue with the next one not added yet
+            while (triangleAdded[scanPosition]) { scanPosition++; }
+            bestTriangle = scanPosition;
+        }
+
+        triangleAdded[bestTriangle] = true;
+
+        int triangle[3];
+        for (int k = 0; k < 3; k++) {
+            triangle[k] = _indices[3 * bestTriangle + k] - _baseVertex;
+            output.push_back(_indices[3 * bestTriangle + k]);
+
+            // Remove the triangle from the vertex's list of remaining triangles
+            auto& vertex = vertices[triangle[k]];
+            int* list = &vertexTriangles[vertex.firstTriangle];
+            for (int i = 0; i < vertex.remaining; i++) {
+                if (list[i] == bestTriangle) {
+                    list[i] = list[vertex.remaining - 1];
+                    break;
+                }
+            }
+            vertex.remaining--;
+        }
+
+        // Move the triangle's vertices to the front of the cache
+        newCache.assign(triangle, triangle + 3);
+        for (int v : cache) {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+                newCache.push_back(v);
+            }
+        }
+        std::swap(cache, newCache);
+
+        for (size_t c = 0; c < cache.size(); c++) {
+            auto& vertex = vertices[cache[c]];
+            vertex.cachePosition = c < VERTEX_CACHE_SIZE ? c : -1;
+        }
+
+        // Update the scores of all vertices in the cache and their triangles, and find the best one
+        float bestScore = -1.f;
+        bestTriangle = -1;
+
+        for (int v : cache) {
+            auto& vertex = vertices[v];
+            float newScore = vertexScore(vertex);
+            float delta = newScore - vertex.score;
+            vertex.score = newScore;
+
+            const int* list = &vertexTriangles[vertex.firstTriangle];
+            for (int i = 0; i < vertex.remaining; i++) {
+                int t = list[i];
+                triangleScores[t] += delta;
+                if (triangleScores[t] > bestScore) {
+                    bestScore = triangleScores[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        if (cache.size() > VERTEX_CACHE_SIZE) {
+            cache.resize(VERTEX_CACHE_SIZE);
+        }
+    }
+
+    std::memcpy(_indices, output.data(), output.size() * sizeof(GLuint));
+}
+
+void VertexCache::optimizeVertices(GLuint* _indices, size_t _nIndices, GLuint _baseVertex, GLbyte* _vertices, size_t _nVertices, size_t _stride) {
+
+    const GLuint unassigned = (GLuint)-1;
+    std::vector<GLuint> remap(_nVertices, unassigned);
+    GLuint next = 0;
+
+    for (size_t i = 0; i < _nIndices; i++) {
+        GLuint& target = remap[_indices[i] - _baseVertex];
+        if (target == unassigned) {
+            target = next++;
+        }
+        _indices[i] = target + _baseVertex;
+    }
+
+    for (auto& target : remap) {
+        if (target == unassigned) {
+            target = next++;
+        }
+    }
+
+    std::vector<GLbyte> reordered(_nVertices * _stride);
+    for (size_t v = 0; v < _nVertices; v++) {
+        std::memcpy(&reordered[remap[v] * _stride], &_vertices[v * _stride], _stride);
+    }
+
+    std::memcpy(_vertices, reordered.data(), reordered.size());
+}
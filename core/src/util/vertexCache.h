@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+#include "gl.h"
+
+#define VERTEX_CACHE_SIZE 32 // Size of the LRU cache modelled when ordering triangles
+#define VERTEX_CACHE_FIFO_SIZE 16 // Size of the FIFO cache modelled when measuring ACMR
+
+/* Reordering of indexed triangle lists for the GPU post-transform vertex cache. Functions work on the
+ * indices of one draw call, which reference the _nVertices vertices starting at _baseVertex */
+namespace VertexCache {
+
+    /* Returns the average cache miss ratio (transformed vertices per triangle) of drawing _indices through
+     * a FIFO cache of _cacheSize vertices; 0.5 is about optimal for regular meshes, 3 is the worst case */
+    float acmr(const GLuint* _indices, size_t _nIndices, size_t _cacheSize = VERTEX_CACHE_FIFO_SIZE);
+
+    /* Reorders the triangles of _indices in place for cache locality, with Tom Forsyth's 'Linear-Speed
+     * Vertex Cache Optimisation': triangles are added greedily by a score favouring vertices recently
+     * used and vertices with few triangles left */
+    void optimizeTriangles(GLuint* _indices, size_t _nIndices, GLuint _baseVertex, size_t _nVertices);
+
+    /* Reorders the vertices in _vertices (of _stride bytes each) by their first use in _indices, so that
+     * vertices are fetched sequentially, and remaps _indices to match; unused vertices are moved to the end */
+    void optimizeVertices(GLuint* _indices, size_t _nIndices, GLuint _baseVertex, GLbyte* _vertices, size_t _nVertices, size_t _stride);
+
+}
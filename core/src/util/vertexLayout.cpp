@@ -1,6 +1,8 @@
 #include "vertexLayout.h"
+#include "vboMesh.h"
 
-std::unordered_map<GLint, GLuint> VertexLayout::s_enabledAttribs = std::unordered_map<GLint, GLuint>();
+std::vector<VertexLayout::AttribState> VertexLayout::s_attribs;
+unsigned int VertexLayout::s_enableCount = 0;
 
 VertexLayout::VertexLayout(std::vector<VertexAttrib> _attribs) : m_attribs(_attribs) {
 
@@ -40,36 +42,107 @@ VertexLayout::~VertexLayout() {
 
 }
 
+void VertexLayout::resolveLocations(ShaderProgram& _program) {
+
+    if (m_locationsBuildId == _program.getBuildId()) {
+        return;
+    }
+
+    m_locations.clear();
+    for (auto& attrib : m_attribs) {
+        m_locations.push_back(_program.getAttribLocation(attrib.name));
+    }
+
+    m_locationsBuildId = _program.getBuildId();
+
+}
+
 void VertexLayout::enable(ShaderProgram& _program, size_t byteOffset, void* _ptr) {
 
-    GLuint glProgram = _program.getGlProgram();
+    // The cached state is that of the default vertex array
+    VboMesh::bindVertexArray(0);
+
+    resolveLocations(_program);
+
+    unsigned int use = ++s_enableCount;
+    GLuint buffer = _ptr ? (GLuint)-1 : VboMesh::getBoundBuffer(GL_ARRAY_BUFFER);
 
     // Enable all attributes for this layout
-    for (auto& attrib : m_attribs) {
+    for (size_t i = 0; i < m_attribs.size(); i++) {
 
-        GLint location = _program.getAttribLocation(attrib.name);
+        const auto& attrib = m_attribs[i];
+        GLint location = m_locations[i];
 
-        if (location != -1) {
+        if (location == -1) {
+            continue;
+        }
+
+        if (location >= (GLint)s_attribs.size()) {
+            s_attribs.resize(location + 1);
+        }
+
+        AttribState& state = s_attribs[location];
+        state.lastUse = use;
+
+        if (!state.enabled) {
             glEnableVertexAttribArray(location);
+            state.enabled = true;
+        }
+
+        const GLvoid* data = _ptr ? _ptr : ((unsigned char*) attrib.offset) + byteOffset;
+
+        // Client-side pointers are always set, the data they point to may have moved
+        if (_ptr || state.buffer != buffer || state.pointer != data || state.size != attrib.size || state.type != attrib.type
+            || state.normalized != attrib.normalized || state.stride != m_stride) {
 
-            void* data = _ptr ? _ptr : ((unsigned char*) attrib.offset) + byteOffset;
             glVertexAttribPointer(location, attrib.size, attrib.type, attrib.normalized, m_stride, data);
-            s_enabledAttribs[location] = glProgram; // Track currently enabled attribs by the program to which they are bound
+
+            state.buffer = buffer;
+            state.pointer = data;
+            state.size = attrib.size;
+            state.type = attrib.type;
+            state.normalized = attrib.normalized;
+            state.stride = m_stride;
         }
 
     }
 
-    // Disable previously bound and now-unneeded attributes
-    for (auto& locationProgramPair : s_enabledAttribs) {
+    // Disable previously enabled and now-unneeded attributes
+    for (size_t location = 0; location < s_attribs.size(); location++) {
 
-        const GLint& location = locationProgramPair.first;
-        GLuint& boundProgram = locationProgramPair.second;
+        AttribState& state = s_attribs[location];
 
-        if (boundProgram != glProgram && boundProgram != 0) {
+        if (state.enabled && state.lastUse != use) {
             glDisableVertexAttribArray(location);
-            boundProgram = 0;
+            state.enabled = false;
+        }
+
+    }
+
+}
+
+void VertexLayout::enableVertexArray(ShaderProgram& _program, size_t byteOffset) {
+
+    resolveLocations(_program);
+
+    for (size_t i = 0; i < m_attribs.size(); i++) {
+
+        const auto& attrib = m_attribs[i];
+        GLint location = m_locations[i];
+
+        if (location != -1) {
+            glEnableVertexAttribArray(location);
+
+            void* data = ((unsigned char*) attrib.offset) + byteOffset;
+            glVertexAttribPointer(location, attrib.size, attrib.type, attrib.normalized, m_stride, data);
         }
 
     }
 
 }
+
+void VertexLayout::clearCache() {
+
+    s_attribs.clear();
+
+}
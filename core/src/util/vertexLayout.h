@@ -1,7 +1,6 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
 #include <memory>
 
 #include "gl.h"
@@ -23,15 +22,48 @@ public:
 
     virtual ~VertexLayout();
 
+    /*
+     * Enables the attributes of this layout for _program, reading vertices at byteOffset in the bound array
+     * buffer (or at _ptr, if given), and disables all others; the state of each attribute location is cached,
+     * so only what differs from the previous call is changed. Must be used without a vertex array object bound
+     */
     void enable(ShaderProgram& _program, size_t byteOffset, void* _ptr = nullptr);
 
+    /*
+     * Enables the attributes of this layout for _program in the bound, newly created vertex array object,
+     * reading vertices at byteOffset in the bound array buffer; bypasses the cached attribute state
+     */
+    void enableVertexArray(ShaderProgram& _program, size_t byteOffset);
+
     GLint getStride() const { return m_stride; };
 
+    /* Forgets the cached attribute state; must be called when the GL context is lost */
+    static void clearCache();
+
 private:
 
-    static std::unordered_map<GLint, GLuint> s_enabledAttribs; // Map from attrib locations to bound shader program
+    /* Cached state of a generic vertex attribute location outside of vertex array objects */
+    struct AttribState {
+        bool enabled = false;
+        unsigned int lastUse = 0; // Value of <s_enableCount> when the location was last part of a layout
+        GLuint buffer = 0; // Array buffer bound when the pointer was set, or -1 for client-side pointers
+        const GLvoid* pointer = nullptr;
+        GLint size = 0;
+        GLenum type = 0;
+        GLboolean normalized = GL_FALSE;
+        GLsizei stride = 0;
+    };
+
+    static std::vector<AttribState> s_attribs; // Indexed by attribute location
+    static unsigned int s_enableCount; // Number of calls to enable()
+
+    /* Resolves the attribute locations of this layout in _program, if not done for its current build */
+    void resolveLocations(ShaderProgram& _program);
 
     std::vector<VertexAttrib> m_attribs;
     GLint m_stride;
 
+    std::vector<GLint> m_locations; // Location of each attribute in the program identified by <m_locationsBuildId>
+    int m_locationsBuildId = -1;
+
 };
@@ -95,7 +95,7 @@ public:
     const glm::mat4& getProjectionMatrix() const { return m_proj; }
 
     /* Gets the combined view and projection transformation */
-    const glm::mat4 getViewProjectionMatrix() const { return m_viewProj; }
+    const glm::mat4& getViewProjectionMatrix() const { return m_viewProj; }
 
     /* Gets the normal matrix; transforms surface normals from model space to camera space */
     const glm::mat3& getNormalMatrix() const { return m_normalMatrix; }
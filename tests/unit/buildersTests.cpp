@@ -0,0 +1,69 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "builders.h"
+
+void checkPolyLineSize(const Line& _line, PolyLineOptions _options) {
+    size_t reserved = 0;
+    size_t emitted = 0;
+
+    auto builder = makePolyLineBuilder(
+        [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) { emitted++; },
+        [&](size_t sizeHint) { reserved = sizeHint; },
+        _options
+    );
+
+    Builders::buildPolyLine(_line, builder);
+
+    size_t numVertices, numIndices;
+    Builders::polyLineSize(_line.size(), _options, numVertices, numIndices);
+
+    REQUIRE(reserved == emitted);
+    REQUIRE(numVertices == emitted);
+    REQUIRE(numIndices == builder.indices.size());
+}
+
+TEST_CASE( "Polyline size hints match the emitted geometry", "[BUILDERS][LINES]" ) {
+    Line line = { {0.f, 0.f, 0.f}, {0.5f, 0.f, 0.f}, {0.5f, 0.5f, 0.f}, {0.f, 1.f, 0.f}, {-0.5f, 0.5f, 0.f} };
+
+    for (auto cap : { CapTypes::BUTT, CapTypes::SQUARE, CapTypes::ROUND }) {
+        for (auto join : { JoinTypes::MITER, JoinTypes::BEVEL, JoinTypes::ROUND }) {
+            checkPolyLineSize(line, PolyLineOptions(cap, join));
+            checkPolyLineSize(Line(line.begin(), line.begin() + 2), PolyLineOptions(cap, join));
+        }
+    }
+}
+
+float triangulatedArea(const Triangulation& _triangulation) {
+    const float* v = _triangulation.vertices();
+    const int* idx = _triangulation.indices();
+    float area = 0.f;
+    for (int i = 0; i < _triangulation.triangleCount(); i++) {
+        const float* a = &v[3 * idx[3*i]];
+        const float* b = &v[3 * idx[3*i+1]];
+        const float* c = &v[3 * idx[3*i+2]];
+        float doubleArea = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+        REQUIRE(doubleArea >= 0.f); // counter-clockwise
+        area += doubleArea * .5f;
+    }
+    return area;
+}
+
+TEST_CASE( "Simple rings are triangulated without the tesselator", "[BUILDERS][POLYGONS]" ) {
+    Triangulation triangulation;
+
+    // clockwise closed quad
+    Polygon quad = { { {0.f, 0.f, 1.f}, {0.f, 1.f, 1.f}, {1.f, 1.f, 1.f}, {1.f, 0.f, 1.f}, {0.f, 0.f, 1.f} } };
+    REQUIRE(triangulation.triangulate(quad));
+    REQUIRE(triangulation.vertexCount() == 4);
+    REQUIRE(triangulation.triangleCount() == 2);
+    REQUIRE(triangulation.vertices()[2] == 1.f);
+    REQUIRE(triangulatedArea(triangulation) == Approx(1.f));
+
+    // concave L-shape
+    Polygon lshape = { { {0.f, 0.f, 0.f}, {2.f, 0.f, 0.f}, {2.f, 1.f, 0.f}, {1.f, 1.f, 0.f}, {1.f, 2.f, 0.f}, {0.f, 2.f, 0.f} } };
+    REQUIRE(triangulation.triangulate(lshape));
+    REQUIRE(triangulation.vertexCount() == 6);
+    REQUIRE(triangulation.triangleCount() == 4);
+    REQUIRE(triangulatedArea(triangulation) == Approx(3.f));
+}
@@ -0,0 +1,64 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "clipping.h"
+
+TEST_CASE( "Lines are clipped into the visible parts", "[CLIPPING][LINES]" ) {
+    Line line = { {-2.f, 0.f, 0.f}, {0.f, 0.f, 0.f}, {2.f, 0.f, 0.f}, {2.f, 2.f, 0.f}, {0.5f, 0.5f, 0.f} };
+    std::vector<Line> clipped;
+
+    Clipping::clipLine(line, -1.f, 1.f, clipped);
+
+    REQUIRE(clipped.size() == 2);
+    REQUIRE(clipped[0].size() == 3);
+    REQUIRE(clipped[0].front() == Point(-1.f, 0.f, 0.f));
+    REQUIRE(clipped[0].back() == Point(1.f, 0.f, 0.f));
+    REQUIRE(clipped[1].size() == 2);
+    REQUIRE(clipped[1].front() == Point(1.f, 1.f, 0.f));
+    REQUIRE(clipped[1].back() == Point(0.5f, 0.5f, 0.f));
+}
+
+TEST_CASE( "Closed rings stay closed when clipped", "[CLIPPING][POLYGONS]" ) {
+    Line ring = { {-2.f, -2.f, 0.f}, {0.f, -2.f, 0.f}, {0.f, 0.f, 0.f}, {-2.f, 0.f, 0.f}, {-2.f, -2.f, 0.f} };
+    Line clipped;
+
+    Clipping::clipRing(ring, -1.f, 1.f, clipped);
+
+    REQUIRE(clipped.size() == 5);
+    REQUIRE(clipped.front() == Point(-1.f, -1.f, 0.f));
+    REQUIRE(clipped.front() == clipped.back());
+
+    Line outside = { {2.f, 2.f, 0.f}, {3.f, 2.f, 0.f}, {3.f, 3.f, 0.f}, {2.f, 2.f, 0.f} };
+    Clipping::clipRing(outside, -1.f, 1.f, clipped);
+
+    REQUIRE(clipped.empty());
+}
+
+TEST_CASE( "Simplification removes points within tolerance and keeps end points", "[CLIPPING][SIMPLIFY]" ) {
+    Line line = { {0.f, 0.f, 0.f}, {1.f, 0.01f, 0.f}, {2.f, 0.f, 0.f}, {3.f, 1.f, 0.f}, {4.f, 0.f, 0.f} };
+
+    Clipping::simplify(line, 0.1f);
+
+    REQUIRE(line.size() == 4);
+    REQUIRE(line.front() == Point(0.f, 0.f, 0.f));
+    REQUIRE(line[1] == Point(2.f, 0.f, 0.f));
+    REQUIRE(line.back() == Point(4.f, 0.f, 0.f));
+}
+
+TEST_CASE( "Rings simplified to fewer than 3 distinct points are dropped", "[CLIPPING][POLYGONS]" ) {
+    REQUIRE(Clipping::isDegenerateRing({ {0.f, 0.f, 0.f}, {0.5f, 0.f, 0.f}, {0.f, 0.f, 0.f} }));
+    REQUIRE(Clipping::isDegenerateRing({ {0.f, 0.f, 0.f}, {0.5f, 0.f, 0.f}, {0.5f, 0.f, 0.f}, {0.f, 0.f, 0.f} }));
+    REQUIRE_FALSE(Clipping::isDegenerateRing({ {0.f, 0.f, 0.f}, {0.5f, 0.f, 0.f}, {0.5f, 0.5f, 0.f}, {0.f, 0.f, 0.f} }));
+
+    // A thin closed ring which Douglas-Peucker reduces to [a, b, a]
+    TileData data;
+    data.layers.emplace_back("test");
+    Feature feature;
+    feature.geometryType = GeometryType::POLYGONS;
+    feature.polygons.push_back({ { {0.f, 0.f, 0.f}, {0.5f, 0.01f, 0.f}, {0.f, 0.f, 0.f} } });
+    data.layers[0].features.push_back(feature);
+
+    Clipping::processTileData(data, 0.f, 0.1f);
+
+    REQUIRE(data.layers[0].features[0].polygons.empty());
+}
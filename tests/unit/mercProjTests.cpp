@@ -30,3 +30,21 @@ TEST_CASE( "Testing some functionality for mercator projection", "[MERCATOR][PRO
     REQUIRE( (testLonLat.x - lonLat.x) < epsilon);
     REQUIRE( (testLonLat.y - lonLat.y) < epsilon);
 }
+
+TEST_CASE( "Batch projection into tile coordinates matches single projection", "[MERCATOR][PROJECTION]" ) {
+    MercatorProjection mercProjection = MercatorProjection();
+    glm::dvec2 lonLats[] = { {0.0, 0.0}, {-73.98, 40.75}, {139.69, 35.69}, {-0.12, 51.5}, {151.2, -33.87} };
+    size_t count = sizeof(lonLats) / sizeof(lonLats[0]);
+    glm::dvec2 origin = mercProjection.LonLatToMeters(glm::dvec2(-74.0, 40.7));
+    double invScale = 1.0 / 2445.98;
+    glm::vec3 tileCoords[5];
+
+    mercProjection.LonLatToTileCoords(lonLats, count, origin, invScale, tileCoords);
+
+    for (size_t i = 0; i < count; i++) {
+        glm::dvec2 meters = mercProjection.LonLatToMeters(lonLats[i]);
+        REQUIRE( std::abs(tileCoords[i].x - (meters.x - origin.x) * invScale) < 1e-3 * std::abs(tileCoords[i].x) + 1e-3 );
+        REQUIRE( std::abs(tileCoords[i].y - (meters.y - origin.y) * invScale) < 1e-3 * std::abs(tileCoords[i].y) + 1e-3 );
+        REQUIRE( tileCoords[i].z == 0.f );
+    }
+}
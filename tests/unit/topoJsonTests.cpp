@@ -0,0 +1,110 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "rapidjson/document.h"
+
+#include "topoJson.h"
+#include "mapProjection.h"
+#include "mapTile.h"
+
+// Arcs (10, 10)-(11, 10)-(11, 11) and (11, 12)-(12, 12); quantized with scale 0.5 and translate 10,
+// as deltas from the previous position of the arc
+const char* s_topology = R"END(
+{
+    "transform": { "scale": [0.5, 0.5], "translate": [10, 10] },
+    "arcs": [ [[0, 0], [2, 0], [0, 2]], [[2, 4], [2, 0]] ],
+    "objects": {}
+}
+)END";
+
+// Same arcs in absolute, unquantized positions
+const char* s_absoluteTopology = R"END(
+{
+    "arcs": [ [[10, 10], [11, 10], [11, 11]], [[11, 12], [12, 12]] ],
+    "objects": {}
+}
+)END";
+
+TEST_CASE( "Quantized arcs are decoded from deltas", "[TOPOJSON]" ) {
+    MercatorProjection projection;
+    MapTile tile(TileID(0, 0, 0), projection);
+
+    rapidjson::Document doc;
+    doc.Parse(s_topology);
+    TopoJson::Topology topology;
+    TopoJson::extractTopology(doc, topology, tile);
+
+    rapidjson::Document absoluteDoc;
+    absoluteDoc.Parse(s_absoluteTopology);
+    TopoJson::Topology absolute;
+    TopoJson::extractTopology(absoluteDoc, absolute, tile);
+
+    REQUIRE(topology.quantized);
+    REQUIRE(topology.arcs.size() == 2);
+    REQUIRE(topology.arcs[0] == absolute.arcs[0]);
+    REQUIRE(topology.arcs[1] == absolute.arcs[1]);
+}
+
+TEST_CASE( "Lines join arcs, reversing ~i references and skipping shared end points", "[TOPOJSON]" ) {
+    MercatorProjection projection;
+    MapTile tile(TileID(0, 0, 0), projection);
+
+    rapidjson::Document doc;
+    doc.Parse(R"END({ "arcs": [ [[0, 0], [1, 0], [1, 1]], [[1, 1], [2, 1]] ] })END");
+    TopoJson::Topology topology;
+    TopoJson::extractTopology(doc, topology, tile);
+
+    const Line& first = topology.arcs[0];
+    const Line& second = topology.arcs[1];
+
+    rapidjson::Document refs;
+    refs.Parse("[[0, 1], [-2, -1]]");
+
+    Line forward;
+    TopoJson::extractLine(refs[0], forward, topology);
+
+    REQUIRE(forward.size() == 4);
+    REQUIRE(forward[0] == first[0]);
+    REQUIRE(forward[2] == first[2]);
+    REQUIRE(forward[3] == second[1]);
+
+    Line backward;
+    TopoJson::extractLine(refs[1], backward, topology);
+
+    REQUIRE(backward.size() == 4);
+    REQUIRE(backward[0] == second[1]);
+    REQUIRE(backward[1] == second[0]);
+    REQUIRE(backward[3] == first[0]);
+}
+
+TEST_CASE( "Malformed geometries are skipped and collection properties are inherited", "[TOPOJSON]" ) {
+    MercatorProjection projection;
+    MapTile tile(TileID(0, 0, 0), projection);
+
+    rapidjson::Document doc;
+    doc.Parse(R"END({ "arcs": [ [[0, 0], [1, 0]], "bad" ] })END");
+    TopoJson::Topology topology;
+    TopoJson::extractTopology(doc, topology, tile);
+
+    REQUIRE(topology.arcs.size() == 2);
+    REQUIRE(topology.arcs[1].empty());
+
+    rapidjson::Document layerDoc;
+    layerDoc.Parse(R"END({
+        "type": "GeometryCollection",
+        "geometries": [
+            { "arcs": [0] },
+            { "type": "LineString", "arcs": [ "x", 0, 5 ] },
+            { "type": "GeometryCollection", "properties": { "kind": "road", "lanes": 2 },
+              "geometries": [ { "type": "LineString", "arcs": [0], "properties": { "kind": "path" } } ] }
+        ]
+    })END");
+
+    Layer layer("test");
+    TopoJson::extractLayer(layerDoc, layer, topology, tile);
+
+    REQUIRE(layer.features.size() == 2);
+    REQUIRE(layer.features[0].lines[0].size() == 2);
+    REQUIRE(layer.features[1].props.stringProps["kind"] == "path");
+    REQUIRE(layer.features[1].props.numericProps["lanes"] == 2.f);
+}
@@ -0,0 +1,77 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "typedMesh.h"
+#include "vertexLayout.h"
+
+// Exposes the compiled batches of a mesh
+class BatchedMesh : public TypedMesh<GLuint> {
+public:
+    BatchedMesh(std::shared_ptr<VertexLayout> _layout) : TypedMesh<GLuint>(_layout, GL_TRIANGLES) {}
+
+    using VboMesh::m_vertexOffsets;
+    using VboMesh::m_glIndexData;
+    using VboMesh::m_glVertexData;
+};
+
+TEST_CASE( "A feature too large for 16 bit indices is split into batches", "[VBOMESH]" ) {
+    auto layout = std::shared_ptr<VertexLayout>(new VertexLayout({
+        {"a_id", 1, GL_UNSIGNED_INT, false, 0}
+    }));
+    BatchedMesh mesh(layout);
+
+    // A strip of quads over 100000 vertices; each vertex holds its own id
+    const GLuint nVertices = 100000;
+    std::vector<GLuint> vertices(nVertices);
+    std::vector<int> indices;
+    for (GLuint i = 0; i < nVertices; i++) { vertices[i] = i; }
+    for (int i = 0; i + 3 < (int)nVertices; i += 2) {
+        indices.insert(indices.end(), { i, i + 1, i + 2, i + 1, i + 3, i + 2 });
+    }
+    size_t nIndices = indices.size();
+
+    // Triangles as sorted vertex ids, to check that they survive the split
+    std::vector<std::array<GLuint, 3>> before;
+    for (size_t i = 0; i < nIndices; i += 3) {
+        before.push_back({{ (GLuint)indices[i], (GLuint)indices[i + 1], (GLuint)indices[i + 2] }});
+    }
+    std::sort(before.begin(), before.end());
+
+    mesh.addVertices(std::move(vertices), std::move(indices));
+    mesh.compileVertexBuffer();
+
+    REQUIRE(mesh.m_vertexOffsets.size() >= 2);
+    REQUIRE(mesh.numIndices() == (int)nIndices);
+    REQUIRE(mesh.numVertices() > (int)nVertices); // shared vertices are duplicated
+
+    const GLuint* ids = reinterpret_cast<const GLuint*>(mesh.m_glVertexData.data());
+    std::vector<std::array<GLuint, 3>> after;
+    size_t iPos = 0;
+    GLuint vertexOffset = 0;
+    bool inBatch = true;
+
+    for (auto& batch : mesh.m_vertexOffsets) {
+        REQUIRE(batch.second <= 65535);
+        for (size_t i = 0; i < batch.first; i += 3) {
+            std::array<GLuint, 3> t;
+            for (int k = 0; k < 3; k++) {
+                GLushort idx = mesh.m_glIndexData[iPos + i + k];
+                inBatch &= idx < batch.second;
+                t[k] = ids[vertexOffset + idx];
+            }
+            after.push_back(t);
+        }
+        iPos += batch.first;
+        vertexOffset += batch.second;
+    }
+    std::sort(after.begin(), after.end());
+
+    REQUIRE(inBatch);
+
+    REQUIRE(after == before);
+}
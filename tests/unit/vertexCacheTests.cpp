@@ -0,0 +1,60 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "vertexCache.h"
+
+// Triangles of a _size x _size grid of quads, in column order with vertices numbered by row
+std::vector<GLuint> gridIndices(GLuint _size, GLuint _baseVertex) {
+    std::vector<GLuint> indices;
+    for (GLuint x = 0; x < _size; x++) {
+        for (GLuint y = 0; y < _size; y++) {
+            GLuint v = _baseVertex + y * (_size + 1) + x;
+            indices.insert(indices.end(), { v, v + 1, v + _size + 1, v + 1, v + _size + 2, v + _size + 1 });
+        }
+    }
+    return indices;
+}
+
+std::vector<std::array<GLuint, 3>> sortedTriangles(const std::vector<GLuint>& _indices, const std::vector<GLuint>& _vertexIds, GLuint _baseVertex) {
+    std::vector<std::array<GLuint, 3>> triangles;
+    for (size_t i = 0; i < _indices.size(); i += 3) {
+        std::array<GLuint, 3> t = {{ _vertexIds[_indices[i] - _baseVertex], _vertexIds[_indices[i+1] - _baseVertex], _vertexIds[_indices[i+2] - _baseVertex] }};
+        // rotate to the smallest id, keeping the winding
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        triangles.push_back(t);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+TEST_CASE( "Vertex cache optimization keeps the triangles and lowers the miss ratio", "[VERTEXCACHE]" ) {
+    const GLuint size = 32;
+    const GLuint base = 10;
+    const size_t nVertices = (size + 1) * (size + 1);
+
+    std::vector<GLuint> indices = gridIndices(size, base);
+
+    // Vertices are their own ids, to check that indices are remapped with them
+    std::vector<GLuint> vertexIds(nVertices);
+    for (size_t i = 0; i < nVertices; i++) { vertexIds[i] = i; }
+
+    auto before = sortedTriangles(indices, vertexIds, base);
+    float acmrBefore = VertexCache::acmr(indices.data(), indices.size());
+
+    VertexCache::optimizeTriangles(indices.data(), indices.size(), base, nVertices);
+    VertexCache::optimizeVertices(indices.data(), indices.size(), base, reinterpret_cast<GLbyte*>(vertexIds.data()), nVertices, sizeof(GLuint));
+
+    REQUIRE(sortedTriangles(indices, vertexIds, base) == before);
+    REQUIRE(VertexCache::acmr(indices.data(), indices.size()) < acmrBefore);
+
+    // vertices are in order of first use
+    GLuint next = base;
+    for (GLuint idx : indices) {
+        REQUIRE(idx <= next);
+        if (idx == next) { next++; }
+    }
+}
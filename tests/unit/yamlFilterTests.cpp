@@ -245,3 +245,32 @@ TEST_CASE( "yaml-filter-tests: boolean false filter as existence check for keywo
     delete filter;
 }
 
+
+TEST_CASE( "yaml-filter-tests: compiled filters agree with filter trees", "[filters][core][yaml]") {
+    init();
+    std::vector<std::string> filters = {
+        "filter: { series: 3}",
+        "filter: { name : [civic, bmw320i] }",
+        "filter: { wheel : { min: 3, max: 5 } }",
+        "filter: { any : [ { name : civic }, { brand : bmw } ] }",
+        "filter: { none : [ { name : civic }, { wheel : 2 } ] }",
+        "filter: { not : { drive : fwd } }",
+        "filter: { all : [ { type : car }, { check : true } ] }",
+        "filter: { $vroom : 1, brand : honda }",
+        "filter: { $zooooom : [false, yes], series : false }"
+    };
+
+    for (const auto& source : filters) {
+        YAML::Node node = YAML::Load(source);
+        Filter* filter = sceneLoader.generateFilter(node["filter"]);
+        CompiledFilter compiled(*filter);
+
+        for (const Feature* feature : { &civic, &bmw1, &bike }) {
+            REQUIRE(compiled.eval(*feature, ctx) == filter->eval(*feature, ctx));
+        }
+
+        delete filter;
+    }
+
+    REQUIRE(CompiledFilter().eval(civic, ctx));
+}
@@ -22,7 +22,7 @@ set(ADDITIONNAL_TARGET_DEPENDENT_SRC_FILES
 set(INSTALL_CORE_LIBRARY "ON")
 set(CORE_LIB_TYPE SHARED)
 set(CORE_INSTALLATION_PATH ${CMAKE_SOURCE_DIR}/android/tangram/libs/${ANDROID_ABI})
-set(CORE_LIB_DEPS GLESv2)
+set(CORE_LIB_DEPS GLESv2 EGL)
 set(CORE_LIB_NAME tangram) # in order to have libtangram.so
 
 add_subdirectory(${PROJECT_SOURCE_DIR}/core)